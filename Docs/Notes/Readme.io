@@ -36,6 +36,7 @@ amr.plot_headerversion        (def:  Version_v1  (1) )
 amr.checkpoint_headerversion  (def:  Version_v1  (1) )
 amr.prereadFAHeaders          (def:  true)
 amr.precreateDirectories      (def:  true)
+amr.checkpoint_max_inflight   (def:  2, with amrex.async_out = 1)
 
 particles.particles_nfiles = 1024
 
@@ -7,6 +7,8 @@
 #include <iomanip>
 #include <limits>
 #include <cmath>
+#include <chrono>
+#include <future>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -84,6 +86,7 @@ namespace
     bool plot_files_output;
     int  checkpoint_nfiles;
     int  regrid_on_restart;
+    int  chop_grids_on_restart;
     int  use_efficient_regrid;
     int  plotfile_on_restart;
     int  insitu_on_restart;
@@ -92,6 +95,7 @@ namespace
     int  compute_new_dt_on_regrid;
     bool precreateDirectories;
     bool prereadFAHeaders;
+    int  checkpoint_max_inflight;
     VisMF::Header::Version plot_headerversion(VisMF::Header::Version_v1);
     VisMF::Header::Version checkpoint_headerversion(VisMF::Header::Version_v1);
 //}
@@ -119,6 +123,7 @@ Amr::Initialize ()
     plot_files_output        = true;
     checkpoint_nfiles        = 64;
     regrid_on_restart        = 0;
+    chop_grids_on_restart    = 0;
     use_efficient_regrid     = 0;
     plotfile_on_restart      = 0;
     insitu_on_restart        = 0;
@@ -127,6 +132,7 @@ Amr::Initialize ()
     compute_new_dt_on_regrid = 0;
     precreateDirectories     = true;
     prereadFAHeaders         = true;
+    checkpoint_max_inflight  = 2;
     plot_headerversion       = VisMF::Header::Version_v1;
     checkpoint_headerversion = VisMF::Header::Version_v1;
 #ifdef BL_USE_SENSEI_INSITU
@@ -170,6 +176,12 @@ Amr::RegridOnRestart () const noexcept
     return regrid_on_restart;
 }
 
+bool
+Amr::ChopGridsOnRestart () const noexcept
+{
+    return chop_grids_on_restart;
+}
+
 void
 Amr::setDtMin (const Vector<Real>& dt_min_in) noexcept
 {
@@ -258,6 +270,7 @@ Amr::InitAmr ()
     // Check for command line flags.
     //
     pp.query("regrid_on_restart",regrid_on_restart);
+    pp.query("chop_grids_on_restart",chop_grids_on_restart);
     pp.query("use_efficient_regrid",use_efficient_regrid);
     pp.query("plotfile_on_restart",plotfile_on_restart);
     pp.query("insitu_on_restart",insitu_on_restart);
@@ -731,6 +744,8 @@ Amr::deleteDeriveSmallPlotVar (const std::string& name)
 
 Amr::~Amr ()
 {
+    retireCheckPoints(0);
+
     levelbld->variableCleanUp();
 
     Amr::Finalize();
@@ -1692,6 +1707,14 @@ Amr::checkPoint ()
 
     Real dCheckPointTime0 = amrex::second();
 
+    //
+    // With AsyncOut, keep at most checkpoint_max_inflight checkpoints
+    // being written in the background, including this one.
+    //
+    if (AsyncOut::UseAsyncOut()) {
+        retireCheckPoints(checkpoint_max_inflight-1);
+    }
+
     const std::string& ckfile = amrex::Concatenate(check_file_root,level_steps[0],file_name_digits);
 
     if(verbose > 0) {
@@ -1705,8 +1728,10 @@ Amr::checkPoint ()
   amrex::StreamRetry sretry(ckfile, abort_on_stream_retry_failure,
                              stream_max_tries);
 
-  // For AsyncOut, we need to turn off stream retry and write to ckfile directly.
-  const std::string ckfileTemp = (AsyncOut::UseAsyncOut()) ? ckfile : (ckfile + ".temp");
+  // For AsyncOut, we need to turn off stream retry.  The data are still
+  // written to ckfileTemp and renamed by retireCheckPoints once the
+  // background writes have finished on all processes.
+  const std::string ckfileTemp(ckfile + ".temp");
 
   while(sretry.TryFileOutput()) {
 
@@ -1831,6 +1856,17 @@ Amr::checkPoint ()
     }
 
     if (AsyncOut::UseAsyncOut()) {
+        if (ParallelDescriptor::IOProcessor()) {
+            HeaderFile.close();
+        }
+        //
+        // The background thread runs jobs in order, so this marker
+        // completes after all the VisMF::AsyncWrite jobs submitted above.
+        //
+        auto done = std::make_shared<std::promise<void> >();
+        pending_checkpoints.push_back({ckfileTemp, ckfile, done->get_future()});
+        AsyncOut::Submit([=] () { done->set_value(); });
+        retireFinishedCheckPoints();
         break;
     } else {
         ParallelDescriptor::Barrier("Amr::checkPoint::end");
@@ -1851,6 +1887,55 @@ Amr::checkPoint ()
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
 
+void
+Amr::retireCheckPoints (int max_inflight)
+{
+    max_inflight = std::max(max_inflight, 0);
+
+    while (static_cast<int>(pending_checkpoints.size()) > max_inflight)
+    {
+        BL_PROFILE("Amr::retireCheckPoints()");
+
+        pending_checkpoints.front().done.wait();
+
+        ParallelDescriptor::Barrier("Amr::retireCheckPoints");
+        renameCheckPoint();
+    }
+}
+
+void
+Amr::retireFinishedCheckPoints ()
+{
+    while (!pending_checkpoints.empty())
+    {
+        BL_PROFILE("Amr::retireFinishedCheckPoints()");
+
+        bool finished = pending_checkpoints.front().done.wait_for(std::chrono::seconds(0))
+            == std::future_status::ready;
+        ParallelDescriptor::ReduceBoolAnd(finished);
+        if (!finished) break;
+
+        renameCheckPoint();
+    }
+}
+
+void
+Amr::renameCheckPoint ()
+{
+    auto& ckp = pending_checkpoints.front();
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::rename(ckp.tmpname.c_str(), ckp.name.c_str());
+    }
+    ParallelDescriptor::Barrier("Renaming temporary checkPoint file.");
+
+    if (verbose > 0) {
+        amrex::Print() << "CHECKPOINT: file = " << ckp.name << " completed\n";
+    }
+
+    pending_checkpoints.pop_front();
+}
+
 void
 Amr::RegridOnly (Real time, bool do_io)
 {
@@ -2131,6 +2216,11 @@ Amr::coarseTimeStep (Real stop_time)
     }
 #endif
 
+    //
+    // Rename the checkpoints AsyncOut has finished writing in the meantime.
+    //
+    retireFinishedCheckPoints();
+
     BL_PROFILE_ADD_STEP(level_steps[0]);
     BL_PROFILE_REGION_STOP("Amr::coarseTimeStep()");
     BL_COMM_PROFILE_NAMETAG(stepName.str());
@@ -3210,6 +3300,8 @@ Amr::initPltAndChk ()
 
     pp.query("precreateDirectories", precreateDirectories);
     pp.query("prereadFAHeaders", prereadFAHeaders);
+    pp.query("checkpoint_max_inflight", checkpoint_max_inflight);
+    checkpoint_max_inflight = std::max(checkpoint_max_inflight, 1);
 
     int phvInt(plot_headerversion), chvInt(checkpoint_headerversion);
     pp.query("plot_headerversion", phvInt);
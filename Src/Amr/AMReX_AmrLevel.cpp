@@ -422,6 +422,11 @@ AmrLevel::restart (Amr&          papa,
 	BL_ASSERT(nstate == ndesc);
     }
 
+    if (parent->ChopGridsOnRestart()) {
+        parent->ChopGrids(level, grids, ParallelDescriptor::NProcs());
+    }
+
+    // The data are read directly into the new layout.
     dmap.define(grids);
 
     parent->SetBoxArray(level, grids);
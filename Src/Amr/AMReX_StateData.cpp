@@ -201,7 +201,7 @@ StateData::restart (std::istream&          is,
 	is >> domain_in;
 	grids_in.readFrom(is);
 	BL_ASSERT(domain_in == domain);
-	BL_ASSERT(amrex::match(grids_in,grids));
+	BL_ASSERT(amrex::match(grids_in,grids) || grids_in.contains(grids));
     }
 
     restartDoit(is, chkfile);
@@ -12,6 +12,10 @@
 
 #include <AMReX_OpenMP.H>
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+
 namespace amrex {
 
 #ifdef AMREX_MEM_PROFILING
@@ -24,6 +28,7 @@ Long BARef::total_hash_bytes_hwm = 0L;
 #endif
 
 bool    BARef::initialized = false;
+constexpr int BARef::hash_class_ratio;
 bool BoxArray::initialized = false;
 
 namespace {
@@ -86,6 +91,7 @@ BARef::~BARef ()
     updateMemoryUsage_box(-1);
     updateMemoryUsage_hash(-1);
 #endif	    
+    delete hash.load(std::memory_order_acquire);
 }
 
 void
@@ -99,9 +105,12 @@ BARef::define (std::istream& is, int& ndims)
     ULong tmphash;
     is.ignore(bl_ignore_max, '(') >> maxbox >> tmphash;
     resize(maxbox);
-    auto pos = is.tellg();
+    ndims = AMREX_SPACEDIM;
+    // An empty BoxArray may be the last thing in the stream, so there is
+    // nothing to probe for the number of dimensions.
+    if (maxbox > 0)
     {
-        ndims = AMREX_SPACEDIM;
+        auto pos = is.tellg();
         char c1, c2;
         int itmp;
         is >> std::ws >> c1 >> std::ws >> c2;
@@ -125,8 +134,8 @@ BARef::define (std::istream& is, int& ndims)
             }
 #endif
         }
+        is.seekg(pos, std::ios_base::beg);
     }
-    is.seekg(pos, std::ios_base::beg);
     for (Vector<Box>::iterator it = m_abox.begin(), End = m_abox.end(); it != End; ++it)
         is >> *it;
     is.ignore(bl_ignore_max, ')');
@@ -178,8 +187,7 @@ BARef::resize (Long n) {
     updateMemoryUsage_hash(-1);
 #endif
     m_abox.resize(n);
-    hash.clear();
-    has_hashmap = false;
+    delete hash.exchange(nullptr, std::memory_order_acq_rel);
 #ifdef AMREX_MEM_PROFILING
     updateMemoryUsage_box(1);
 #endif
@@ -206,11 +214,15 @@ BARef::updateMemoryUsage_box (int s)
 void
 BARef::updateMemoryUsage_hash (int s)
 {
-    if (hash.size() > 0) {
-	Long b = sizeof(hash);
-	for (const auto& x: hash) {
-	    b += amrex::gcc_map_node_extra_bytes
-		+ sizeof(IntVect) + amrex::bytesOf(x.second);
+    HashIndex const* p = hash.load(std::memory_order_acquire);
+    if (p != nullptr && !p->empty()) {
+	Long b = sizeof(HashIndex);
+	for (const auto& lev : *p) {
+	    b += sizeof(HashLevel);
+	    for (const auto& x: lev.hash) {
+		b += amrex::gcc_map_node_extra_bytes
+		    + sizeof(IntVect) + amrex::bytesOf(x.second);
+	    }
 	}
 	if (s > 0) {
 	    total_hash_bytes += b;
@@ -1180,11 +1192,11 @@ BoxArray::intersections (const Box&                         bx,
 {
   // This is called too many times BL_PROFILE("BoxArray::intersections()");
 
-    BARef::HashType& BoxHashMap = getHashMap();
+    BARef::HashIndex& BoxHashIndex = getHashMap();
 
     isects.resize(0);
 
-    if (!BoxHashMap.empty())
+    if (!BoxHashIndex.empty())
     {
         BL_ASSERT(bx.ixType() == ixType());
 
@@ -1196,62 +1208,68 @@ BoxArray::intersections (const Box&                         bx,
 	const IntVect& doihi = getDoiHi();
 
 	gbx.setSmall(glo - doihi).setBig(ghi + doilo);
-        gbx.refine(crseRatio()).coarsen(m_ref->crsn);
-	
-        const IntVect& sm = amrex::max(gbx.smallEnd()-1, m_ref->bbox.smallEnd());
-        const IntVect& bg = amrex::min(gbx.bigEnd(),     m_ref->bbox.bigEnd());
+        gbx.refine(crseRatio());
 
-        Box cbx(sm,bg);
-        cbx.normalize();
+        auto& abox = m_ref->m_abox;
 
-	if (!cbx.intersects(m_ref->bbox)) return;
+        for (const auto& lev : BoxHashIndex)
+        {
+            const Box& lgbx = amrex::coarsen(gbx, lev.crsn);
 
-	auto TheEnd = BoxHashMap.cend();
+            const IntVect& sm = amrex::max(lgbx.smallEnd()-1, lev.bbox.smallEnd());
+            const IntVect& bg = amrex::min(lgbx.bigEnd(),     lev.bbox.bigEnd());
 
-        auto& abox = m_ref->m_abox;
+            Box cbx(sm,bg);
+            cbx.normalize();
 
-        for (IntVect iv = cbx.smallEnd(), End = cbx.bigEnd(); iv <= End; cbx.next(iv))
-        {
-            auto it = BoxHashMap.find(iv);
+            if (!cbx.intersects(lev.bbox)) continue;
+
+            const auto& BoxHashMap = lev.hash;
+            auto TheEnd = BoxHashMap.cend();
 
-            if (it != TheEnd)
+            for (IntVect iv = cbx.smallEnd(), End = cbx.bigEnd(); iv <= End; cbx.next(iv))
             {
-                if (m_bat.is_null()) {
-                    for (const int index : it->second)
-                    {
-                        const Box& ibox = abox[index];
-                        const Box& isect = bx & amrex::grow(ibox,ng);
+                auto it = BoxHashMap.find(iv);
 
-                        if (isect.ok())
+                if (it != TheEnd)
+                {
+                    if (m_bat.is_null()) {
+                        for (const int index : it->second)
                         {
-                            isects.push_back(std::pair<int,Box>(index,isect));
-                            if (first_only) return;
+                            const Box& ibox = abox[index];
+                            const Box& isect = bx & amrex::grow(ibox,ng);
+
+                            if (isect.ok())
+                            {
+                                isects.push_back(std::pair<int,Box>(index,isect));
+                                if (first_only) return;
+                            }
                         }
-                    }
-                } else if (m_bat.is_simple()) {
-                    IndexType t = ixType();
-                    IntVect cr = crseRatio();
-                    for (const int index : it->second)
-                    {
-                        const Box& ibox = amrex::convert(amrex::coarsen(abox[index],cr),t);
-                        const Box& isect = bx & amrex::grow(ibox,ng);
-
-                        if (isect.ok())
+                    } else if (m_bat.is_simple()) {
+                        IndexType t = ixType();
+                        IntVect cr = crseRatio();
+                        for (const int index : it->second)
                         {
-                            isects.push_back(std::pair<int,Box>(index,isect));
-                            if (first_only) return;
+                            const Box& ibox = amrex::convert(amrex::coarsen(abox[index],cr),t);
+                            const Box& isect = bx & amrex::grow(ibox,ng);
+
+                            if (isect.ok())
+                            {
+                                isects.push_back(std::pair<int,Box>(index,isect));
+                                if (first_only) return;
+                            }
                         }
-                    }
-                } else {
-                    for (const int index : it->second)
-                    {
-                        const Box& ibox = m_bat.m_op.m_bndryReg(abox[index]);
-                        const Box& isect = bx & amrex::grow(ibox,ng);
-
-                        if (isect.ok())
+                    } else {
+                        for (const int index : it->second)
                         {
-                            isects.push_back(std::pair<int,Box>(index,isect));
-                            if (first_only) return;
+                            const Box& ibox = m_bat.m_op.m_bndryReg(abox[index]);
+                            const Box& isect = bx & amrex::grow(ibox,ng);
+
+                            if (isect.ok())
+                            {
+                                isects.push_back(std::pair<int,Box>(index,isect));
+                                if (first_only) return;
+                            }
                         }
                     }
                 }
@@ -1277,7 +1295,7 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
 
     if (empty()) return;
 
-    BARef::HashType& BoxHashMap = getHashMap();
+    BARef::HashIndex& BoxHashIndex = getHashMap();
 
     BL_ASSERT(bx.ixType() == ixType());
 
@@ -1289,61 +1307,68 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
     const IntVect& doihi = getDoiHi();
 
     gbx.setSmall(glo - doihi).setBig(ghi + doilo);
-    gbx.refine(crseRatio()).coarsen(m_ref->crsn);
+    gbx.refine(crseRatio());
 
-    const IntVect& sm = amrex::max(gbx.smallEnd()-1, m_ref->bbox.smallEnd());
-    const IntVect& bg = amrex::min(gbx.bigEnd(),     m_ref->bbox.bigEnd());
+    Vector<Box> intersect_boxes;
+    auto& abox = m_ref->m_abox;
 
-    Box cbx(sm,bg);
-    cbx.normalize();
+    for (const auto& lev : BoxHashIndex)
+    {
+        const Box& lgbx = amrex::coarsen(gbx, lev.crsn);
 
-    if (!cbx.intersects(m_ref->bbox)) return;
+        const IntVect& sm = amrex::max(lgbx.smallEnd()-1, lev.bbox.smallEnd());
+        const IntVect& bg = amrex::min(lgbx.bigEnd(),     lev.bbox.bigEnd());
 
-    auto TheEnd = BoxHashMap.cend();
+        Box cbx(sm,bg);
+        cbx.normalize();
 
-    Vector<Box> intersect_boxes;
-    auto& abox = m_ref->m_abox;
-    if (m_bat.is_null()) {
-        AMREX_LOOP_3D(cbx, i, j, k,
-        {
-            auto it = BoxHashMap.find(IntVect(AMREX_D_DECL(i,j,k)));
-            if (it != TheEnd) {
-                for (const int index : it->second) {
-                    const Box& ibox = abox[index];
-                    if (bx.intersects(ibox)) {
-                        intersect_boxes.push_back(ibox);
+        if (!cbx.intersects(lev.bbox)) continue;
+
+        const auto& BoxHashMap = lev.hash;
+        auto TheEnd = BoxHashMap.cend();
+
+        if (m_bat.is_null()) {
+            AMREX_LOOP_3D(cbx, i, j, k,
+            {
+                auto it = BoxHashMap.find(IntVect(AMREX_D_DECL(i,j,k)));
+                if (it != TheEnd) {
+                    for (const int index : it->second) {
+                        const Box& ibox = abox[index];
+                        if (bx.intersects(ibox)) {
+                            intersect_boxes.push_back(ibox);
+                        }
                     }
                 }
-            }
-        });
-    } else if (m_bat.is_simple()) {
-        IndexType t = ixType();
-        IntVect cr = crseRatio();
-        AMREX_LOOP_3D(cbx, i, j, k,
-        {
-            auto it = BoxHashMap.find(IntVect(AMREX_D_DECL(i,j,k)));
-            if (it != TheEnd) {
-                for (const int index : it->second) {
-                    const Box& ibox = amrex::convert(amrex::coarsen(abox[index],cr),t);
-                    if (bx.intersects(ibox)) {
-                        intersect_boxes.push_back(ibox);
+            });
+        } else if (m_bat.is_simple()) {
+            IndexType t = ixType();
+            IntVect cr = crseRatio();
+            AMREX_LOOP_3D(cbx, i, j, k,
+            {
+                auto it = BoxHashMap.find(IntVect(AMREX_D_DECL(i,j,k)));
+                if (it != TheEnd) {
+                    for (const int index : it->second) {
+                        const Box& ibox = amrex::convert(amrex::coarsen(abox[index],cr),t);
+                        if (bx.intersects(ibox)) {
+                            intersect_boxes.push_back(ibox);
+                        }
                     }
                 }
-            }
-        });
-    } else {
-        AMREX_LOOP_3D(cbx, i, j, k,
-        {
-            auto it = BoxHashMap.find(IntVect(AMREX_D_DECL(i,j,k)));
-            if (it != TheEnd) {
-                for (const int index : it->second) {
-                    const Box& ibox = m_bat.m_op.m_bndryReg(abox[index]);
-                    if (bx.intersects(ibox)) {
-                        intersect_boxes.push_back(ibox);
+            });
+        } else {
+            AMREX_LOOP_3D(cbx, i, j, k,
+            {
+                auto it = BoxHashMap.find(IntVect(AMREX_D_DECL(i,j,k)));
+                if (it != TheEnd) {
+                    for (const int index : it->second) {
+                        const Box& ibox = m_bat.m_op.m_bndryReg(abox[index]);
+                        if (bx.intersects(ibox)) {
+                            intersect_boxes.push_back(ibox);
+                        }
                     }
                 }
-            }
-        });
+            });
+        }
     }
 
     BoxList newbl(bl.ixType());
@@ -1362,13 +1387,14 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
 void
 BoxArray::clear_hash_bin () const
 {
-    if (!m_ref->hash.empty())
+    BARef::HashIndex* p = m_ref->hash.load(std::memory_order_acquire);
+    if (p != nullptr)
     {
 #ifdef AMREX_MEM_PROFILING
 	m_ref->updateMemoryUsage_hash(-1);
 #endif
-        m_ref->hash.clear();
-        m_ref->has_hashmap = false;
+        m_ref->hash.store(nullptr, std::memory_order_release);
+        delete p;
     }
 }
 
@@ -1388,7 +1414,7 @@ BoxArray::removeOverlap (bool simplify)
 
     uniqify();
 
-    BARef::HashType& BoxHashMap = m_ref->hash;
+    BARef::HashIndex& BoxHashIndex = getHashMap();
 
     const Box EmptyBox;
 
@@ -1416,6 +1442,9 @@ BoxArray::removeOverlap (bool simplify)
 
                 Box& bx = m_ref->m_abox[isects[j].first];
 
+                // The pieces are inside bx, so they can go into its level.
+                BARef::HashLevel& lev = findHashLevel(BoxHashIndex, isects[j].first);
+
                 amrex::boxDiff(bl_diff, bx, isects[j].second);
 
                 bx = EmptyBox;
@@ -1423,7 +1452,7 @@ BoxArray::removeOverlap (bool simplify)
                 for (const Box& b : bl_diff)
                 {
                     m_ref->m_abox.push_back(b);
-                    BoxHashMap[amrex::coarsen(b.smallEnd(),m_ref->crsn)].push_back(size()-1);
+                    lev.hash[amrex::coarsen(b.smallEnd(),lev.crsn)].push_back(size()-1);
                 }
             }
         }
@@ -1482,58 +1511,133 @@ BoxArray::getDoiHi () const noexcept
     return m_bat.doiHi();
 }
 
-BARef::HashType&
+BARef::HashIndex&
 BoxArray::getHashMap () const
 {
-    BARef::HashType& BoxHashMap = m_ref->hash;
-
-    if (m_ref->HasHashMap()) return BoxHashMap;
+    BARef::HashIndex* p = m_ref->hash.load(std::memory_order_acquire);
+    if (p != nullptr) return *p;
 
-#ifdef _OPENMP
-#pragma omp critical(intersections_lock)
-#endif
+    //
+    // One thread builds the index of this BoxArray.  Other threads that
+    // need it wait until it is published; threads working on other
+    // BoxArrays are not blocked.
+    //
+    bool expected = false;
+    if (m_ref->hash_building.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
     {
-        if (BoxHashMap.empty() && size() > 0)
+        p = m_ref->hash.load(std::memory_order_acquire);
+        if (p == nullptr)
         {
-            //
-            // Calculate the bounding box & maximum extent of the boxes.
-            //
-	    IntVect maxext = IntVect::TheUnitVector();
-            Box boundingbox = m_ref->m_abox[0];
-
-	    const int N = size();
-	    for (int i = 0; i < N; ++i)
-            {
-                Box bx = m_ref->m_abox[i];
-                bx.normalize();
-                maxext = amrex::max(maxext, bx.size());
-                boundingbox.minBox(bx);
-            }
+            std::unique_ptr<BARef::HashIndex> index(new BARef::HashIndex);
+            buildHashIndex(*index);
+            p = index.release();
+            m_ref->hash.store(p, std::memory_order_release);
+#ifdef AMREX_MEM_PROFILING
+            m_ref->updateMemoryUsage_hash(1);
+#endif
+        }
+        m_ref->hash_building.store(false, std::memory_order_release);
+    }
+    else
+    {
+        while ((p = m_ref->hash.load(std::memory_order_acquire)) == nullptr) {
+            std::this_thread::yield();
+        }
+    }
 
-            for (int i = 0; i < N; i++)
-            {
-                const IntVect& crsnsmlend 
-		    = amrex::coarsen(m_ref->m_abox[i].smallEnd(),maxext);
-                BoxHashMap[crsnsmlend].push_back(i);
-            }
+    return *p;
+}
 
-            m_ref->crsn = maxext;
-            m_ref->bbox = boundingbox.coarsen(maxext);
-            m_ref->bbox.normalize();
+void
+BoxArray::buildHashIndex (BARef::HashIndex& index) const
+{
+    const int N = size();
+    if (N == 0) return;
 
-#ifdef AMREX_MEM_PROFILING
-	    m_ref->updateMemoryUsage_hash(1);
-#endif
+    auto const& abox = m_ref->m_abox;
 
-#ifdef _OPENMP
-#pragma omp flush
-#pragma omp atomic write
-#endif
-            m_ref->has_hashmap = true;
+    //
+    // Find the maximum extent and the bounding box of the boxes in each
+    // size class, the power of two not less than their largest extent.
+    //
+    struct SizeClass {
+        IntVect maxext;
+        Box     boundingbox;
+        int     level;
+    };
+    std::map<int,SizeClass> size_classes;
+    std::vector<int> box_class(N);
+    for (int i = 0; i < N; ++i)
+    {
+        Box bx = abox[i];
+        bx.normalize();
+        const IntVect& ext = bx.size();
+        int c = 0;
+        while ((1 << c) < ext.max()) ++c;
+        box_class[i] = c;
+        auto it = size_classes.find(c);
+        if (it == size_classes.end()) {
+            size_classes.insert(std::make_pair(c, SizeClass{ext, bx, -1}));
+        } else {
+            it->second.maxext = amrex::max(it->second.maxext, ext);
+            it->second.boundingbox.minBox(bx);
+        }
+    }
+
+    //
+    // Starting from the smallest boxes, merge size classes into one
+    // level as long as the largest extent in the level is no more than
+    // hash_class_ratio times that of its smallest class.  For most
+    // BoxArrays this gives a single level.
+    //
+    std::vector<Box> boundingbox;
+    int level_base = 0;
+    for (auto& kv : size_classes)
+    {
+        SizeClass& sc = kv.second;
+        if (index.empty() ||
+            sc.maxext.max() > BARef::hash_class_ratio * level_base)
+        {
+            index.push_back(BARef::HashLevel{sc.maxext, sc.boundingbox, BARef::HashType()});
+            boundingbox.push_back(sc.boundingbox);
+            level_base = sc.maxext.max();
+        }
+        else
+        {
+            index.back().crsn = amrex::max(index.back().crsn, sc.maxext);
+            boundingbox.back().minBox(sc.boundingbox);
         }
+        sc.level = static_cast<int>(index.size()) - 1;
+    }
+
+    for (int i = 0; i < N; ++i)
+    {
+        BARef::HashLevel& lev = index[size_classes[box_class[i]].level];
+        lev.hash[amrex::coarsen(abox[i].smallEnd(),lev.crsn)].push_back(i);
     }
 
-    return BoxHashMap;
+    for (int ilev = 0, nlevs = index.size(); ilev < nlevs; ++ilev)
+    {
+        index[ilev].bbox = boundingbox[ilev].coarsen(index[ilev].crsn);
+        index[ilev].bbox.normalize();
+    }
+}
+
+BARef::HashLevel&
+BoxArray::findHashLevel (BARef::HashIndex& index, int i) const
+{
+    const Box& bx = m_ref->m_abox[i];
+    for (auto& lev : index)
+    {
+        auto it = lev.hash.find(amrex::coarsen(bx.smallEnd(),lev.crsn));
+        if (it != lev.hash.end() &&
+            std::find(it->second.begin(), it->second.end(), i) != it->second.end())
+        {
+            return lev;
+        }
+    }
+    amrex::Abort("BoxArray::findHashLevel: box not found");
+    return index[0];
 }
 
 void
@@ -1548,6 +1548,13 @@ DistributionMapping::makeKnapSack (const LayoutData<Real>& rcost_local,
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeKnapSack (const LayoutData<Real>& rcost_local, int nmax)
+{
+    Real currentEfficiency, proposedEfficiency;
+    return makeKnapSack(rcost_local, currentEfficiency, proposedEfficiency, nmax);
+}
+
 void
 DistributionMapping::ComputeDistributionMappingEfficiency (const DistributionMapping& dm,
                                                            const Vector<Real>& cost,
@@ -1791,6 +1798,13 @@ DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local,
 
     return r;
 }
+
+DistributionMapping
+DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local)
+{
+    Real currentEfficiency, proposedEfficiency;
+    return makeSFC(rcost_local, currentEfficiency, proposedEfficiency);
+}
     
 std::vector<std::vector<int> >
 DistributionMapping::makeSFC (const BoxArray& ba, bool use_box_vol, const int nprocs)
@@ -0,0 +1,317 @@
+
+#include <AMReX_FabCodec.H>
+#include <AMReX.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace amrex {
+
+namespace {
+
+    // The first byte of a compressed stream
+    enum Method : unsigned char { Raw = 0, ShuffleLZ = 1, Quantized = 2 };
+
+    // The LZ77 coder writes sequences of a token byte (4 bits each for the
+    // number of literals and the match length), the literals, and a 16-bit
+    // offset to the match.  Lengths of 15 or more continue in extra bytes.
+    constexpr Long lz_min_match = 4;
+    constexpr Long lz_max_offset = 65535;
+    constexpr int  lz_hash_bits = 16;
+
+    inline std::uint32_t read32 (const unsigned char* p) noexcept
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline int lzHash (std::uint32_t v) noexcept
+    {
+        return static_cast<int>((v * 2654435761U) >> (32-lz_hash_bits));
+    }
+
+    void putLength (Vector<char>& out, Long len)
+    {
+        for ( ; len >= 255; len -= 255) {
+            out.push_back(static_cast<char>(255));
+        }
+        out.push_back(static_cast<char>(len));
+    }
+
+    // mlen == 0 for the last sequence, which has no match.
+    void putSequence (Vector<char>& out, const unsigned char* lit, Long nlit, Long offset, Long mlen)
+    {
+        const Long ml = (mlen > 0) ? mlen - lz_min_match : 0;
+        out.push_back(static_cast<char>((std::min(nlit,Long(15)) << 4) | std::min(ml,Long(15))));
+        if (nlit >= 15) putLength(out, nlit-15);
+        out.insert(out.end(), lit, lit+nlit);
+        if (mlen > 0) {
+            out.push_back(static_cast<char>(offset & 0xff));
+            out.push_back(static_cast<char>(offset >> 8));
+            if (ml >= 15) putLength(out, ml-15);
+        }
+    }
+
+    void lzCompress (const unsigned char* in, Long n, Vector<char>& out)
+    {
+        std::vector<Long> table(1 << lz_hash_bits, -1);
+        Long anchor = 0;
+        Long ip = 0;
+        while (ip + lz_min_match <= n)
+        {
+            const std::uint32_t v = read32(in+ip);
+            const int h = lzHash(v);
+            const Long ref = table[h];
+            table[h] = ip;
+            if (ref < 0 || ip-ref > lz_max_offset || read32(in+ref) != v) {
+                ++ip;
+                continue;
+            }
+            Long len = lz_min_match;
+            while (ip+len < n && in[ref+len] == in[ip+len]) ++len;
+            putSequence(out, in+anchor, ip-anchor, ip-ref, len);
+            ip += len;
+            anchor = ip;
+        }
+        if (anchor < n) putSequence(out, in+anchor, n-anchor, 0, 0);
+    }
+
+    void corrupt ()
+    {
+        amrex::Abort("FabCodec::Decompress: corrupt data");
+    }
+
+    Long getLength (const unsigned char* in, Long nin, Long& ip)
+    {
+        Long len = 0;
+        unsigned char b;
+        do {
+            if (ip >= nin) corrupt();
+            b = in[ip++];
+            len += b;
+        } while (b == 255);
+        return len;
+    }
+
+    // Returns the number of bytes read.
+    Long lzDecompress (const unsigned char* in, Long nin, unsigned char* out, Long n)
+    {
+        Long ip = 0;
+        Long op = 0;
+        while (op < n)
+        {
+            if (ip >= nin) corrupt();
+            const unsigned char token = in[ip++];
+            Long nlit = token >> 4;
+            if (nlit == 15) nlit += getLength(in, nin, ip);
+            if (ip+nlit > nin || op+nlit > n) corrupt();
+            std::memcpy(out+op, in+ip, nlit);
+            ip += nlit;
+            op += nlit;
+            if (op >= n) break;
+
+            if (ip+2 > nin) corrupt();
+            const Long offset = Long(in[ip]) | (Long(in[ip+1]) << 8);
+            ip += 2;
+            Long mlen = token & 15;
+            if (mlen == 15) mlen += getLength(in, nin, ip);
+            mlen += lz_min_match;
+            if (offset == 0 || offset > op || op+mlen > n) corrupt();
+            // The match may overlap the output, so copy byte by byte.
+            for (Long k = 0; k < mlen; ++k) {
+                out[op+k] = out[op-offset+k];
+            }
+            op += mlen;
+        }
+        return ip;
+    }
+
+    template <class T>
+    void putValue (Vector<char>& out, const T& v)
+    {
+        const char* p = reinterpret_cast<const char*>(&v);
+        out.insert(out.end(), p, p+sizeof(T));
+    }
+
+    template <class T>
+    T getValue (const char* src, Long nbytes, Long& pos)
+    {
+        if (pos + Long(sizeof(T)) > nbytes) corrupt();
+        T v;
+        std::memcpy(&v, src+pos, sizeof(T));
+        pos += sizeof(T);
+        return v;
+    }
+
+    void compressLossless (const Real* src, Long n, Vector<char>& out)
+    {
+        constexpr Long nb = sizeof(Real);
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+        std::vector<unsigned char> shuffled(n*nb);
+        for (Long i = 0; i < n; ++i) {
+            for (Long b = 0; b < nb; ++b) {
+                shuffled[b*n+i] = in[i*nb+b];
+            }
+        }
+
+        const Long start = out.size();
+        out.push_back(static_cast<char>(ShuffleLZ));
+        lzCompress(shuffled.data(), n*nb, out);
+
+        if (Long(out.size()) - start > 1 + n*nb) {  // ---- incompressible
+            out.resize(start);
+            out.push_back(static_cast<char>(Raw));
+            out.insert(out.end(), reinterpret_cast<const char*>(src),
+                       reinterpret_cast<const char*>(src+n));
+        }
+    }
+
+    bool compressLossy (const Real* src, Long n, Real tol, Vector<char>& out)
+    {
+        Real vmin = std::numeric_limits<Real>::max();
+        Real vmax = std::numeric_limits<Real>::lowest();
+        for (Long i = 0; i < n; ++i) {
+            if (!std::isfinite(src[i])) return false;
+            vmin = std::min(vmin, src[i]);
+            vmax = std::max(vmax, src[i]);
+        }
+        if (n == 0) vmin = vmax = 0.0;
+
+        const Real step = 2.0*tol;
+        if ((vmax-vmin)/step > Real(std::int64_t(1) << 52)) return false;
+
+        // Differences of neighboring multiples are small for smooth data.
+        // They are zigzag encoded and written as variable-length integers.
+        std::vector<unsigned char> ints;
+        ints.reserve(n);
+        std::int64_t qprev = 0;
+        for (Long i = 0; i < n; ++i)
+        {
+            const std::int64_t q = std::llround((src[i]-vmin)/step);
+            if (std::abs(vmin + static_cast<Real>(q)*step - src[i]) > tol) return false;
+            const std::int64_t d = q - qprev;
+            std::uint64_t z = (static_cast<std::uint64_t>(d) << 1) ^ static_cast<std::uint64_t>(d >> 63);
+            while (z >= 0x80) {
+                ints.push_back(static_cast<unsigned char>(z | 0x80));
+                z >>= 7;
+            }
+            ints.push_back(static_cast<unsigned char>(z));
+            qprev = q;
+        }
+
+        out.push_back(static_cast<char>(Quantized));
+        putValue(out, vmin);
+        putValue(out, step);
+        putValue(out, static_cast<Long>(ints.size()));
+        lzCompress(ints.data(), ints.size(), out);
+        return true;
+    }
+}
+
+std::string
+FabCodec::Name (Type codec)
+{
+    switch (codec) {
+    case Lossless: return "lossless";
+    case Lossy:    return "lossy";
+    default:       return "none";
+    }
+}
+
+FabCodec::Type
+FabCodec::FromName (const std::string& name)
+{
+    if (name == "none") {
+        return None;
+    } else if (name == "lossless") {
+        return Lossless;
+    } else if (name == "lossy") {
+        return Lossy;
+    }
+    amrex::Abort("FabCodec: unknown codec " + name);
+    return None;
+}
+
+void
+FabCodec::Compress (Type codec, const Real* src, Long n, Real tol, Vector<char>& out)
+{
+    if (codec == Lossy && tol > 0.0) {
+        const Long start = out.size();
+        if (compressLossy(src, n, tol, out)) return;
+        out.resize(start);
+    }
+
+    if (codec == None) {
+        out.push_back(static_cast<char>(Raw));
+        out.insert(out.end(), reinterpret_cast<const char*>(src),
+                   reinterpret_cast<const char*>(src+n));
+    } else {
+        compressLossless(src, n, out);
+    }
+}
+
+void
+FabCodec::Decompress (const char* src, Long nbytes, Real* dst, Long n)
+{
+    if (nbytes < 1) corrupt();
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+    const Long nb = sizeof(Real);
+    Long pos = 1;
+
+    switch (in[0])
+    {
+    case Raw:
+    {
+        if (nbytes != 1 + n*nb) corrupt();
+        std::memcpy(dst, src+1, n*nb);
+        break;
+    }
+    case ShuffleLZ:
+    {
+        std::vector<unsigned char> shuffled(n*nb);
+        lzDecompress(in+1, nbytes-1, shuffled.data(), n*nb);
+        unsigned char* out = reinterpret_cast<unsigned char*>(dst);
+        for (Long i = 0; i < n; ++i) {
+            for (Long b = 0; b < nb; ++b) {
+                out[i*nb+b] = shuffled[b*n+i];
+            }
+        }
+        break;
+    }
+    case Quantized:
+    {
+        const Real vmin = getValue<Real>(src, nbytes, pos);
+        const Real step = getValue<Real>(src, nbytes, pos);
+        const Long nints = getValue<Long>(src, nbytes, pos);
+        if (nints < 0) corrupt();
+        std::vector<unsigned char> ints(nints);
+        lzDecompress(in+pos, nbytes-pos, ints.data(), nints);
+        Long ip = 0;
+        std::int64_t q = 0;
+        for (Long i = 0; i < n; ++i)
+        {
+            std::uint64_t z = 0;
+            int shift = 0;
+            unsigned char b;
+            do {
+                if (ip >= nints || shift > 63) corrupt();
+                b = ints[ip++];
+                z |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+                shift += 7;
+            } while (b & 0x80);
+            q += static_cast<std::int64_t>(z >> 1) ^ -static_cast<std::int64_t>(z & 1);
+            dst[i] = vmin + static_cast<Real>(q)*step;
+        }
+        break;
+    }
+    default:
+        corrupt();
+    }
+}
+
+}
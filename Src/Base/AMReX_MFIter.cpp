@@ -1,13 +1,31 @@
 
 #include <AMReX_MFIter.H>
 #include <AMReX_FabArray.H>
+#include <AMReX_LayoutData.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_OpenMP.H>
 
+#include <mutex>
+
+#ifdef AMREX_TINY_PROFILING
+#include <AMReX_TinyProfiler.H>
+#endif
+
 namespace amrex {
 
 int MFIter::nextDynamicIndex = std::numeric_limits<int>::min();
 
+// Range of tiles [head,tail) left to a thread in work stealing mode.
+// The owner takes tiles from the head and thieves from the tail.
+struct MFIter::StealQueue {
+#ifdef _OPENMP
+    std::mutex mtx;
+#endif
+    int head = 0;
+    int tail = 0;
+    char pad[64];  // keep the queues on separate cache lines
+};
+
 MFIter::MFIter (const FabArrayBase& fabarray_, 
 		unsigned char       flags_)
     :
@@ -145,8 +163,10 @@ MFIter::MFIter (const BoxArray& ba, const DistributionMapping& dm, const MFItInf
     tile_size(info.tilesize),
     flags(info.do_tiling ? Tiling : 0),
     streams(info.num_streams),
-    dynamic(info.dynamic && (OpenMP::get_num_threads() > 1)),
+    dynamic(info.dynamic && !info.work_stealing && (OpenMP::get_num_threads() > 1)),
     device_sync(info.device_sync),
+    work_stealing(info.work_stealing && (OpenMP::get_num_threads() > 1)),
+    m_cost(info.cost),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
@@ -177,8 +197,10 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
     tile_size(info.tilesize),
     flags(info.do_tiling ? Tiling : 0),
     streams(info.num_streams),
-    dynamic(info.dynamic && (OpenMP::get_num_threads() > 1)),
+    dynamic(info.dynamic && !info.work_stealing && (OpenMP::get_num_threads() > 1)),
     device_sync(info.device_sync),
+    work_stealing(info.work_stealing && (OpenMP::get_num_threads() > 1)),
+    m_cost(info.cost),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
@@ -200,6 +222,9 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
 
 MFIter::~MFIter ()
 {
+    // The loop may have been left early.
+    if (m_cost && isValid()) stopCost();
+
 #ifdef BL_USE_TEAM
     if ( ! (flags & NoTeamBarrier) )
 	ParallelDescriptor::MyTeam().MemoryBarrier();
@@ -237,11 +262,19 @@ MFIter::~MFIter ()
 #endif
         m_fa->clearThisBD();
     }
+
+#ifdef AMREX_TINY_PROFILING
+    TinyProfiler::TraceBox(m_prev_trace_box);
+#endif
 }
 
 void
 MFIter::Initialize ()
 {
+#ifdef AMREX_TINY_PROFILING
+    m_prev_trace_box = TinyProfiler::GetTraceBox();
+#endif
+
     if (flags & SkipInit) {
 	return;
     }
@@ -304,7 +337,43 @@ MFIter::Initialize ()
 	int nthreads = omp_get_num_threads();
 	if (nthreads > 1)
 	{
-            if (dynamic)
+            if (work_stealing)
+            {
+                // Seed the queues with the static partition moved to box
+                // boundaries, so the tiles of a box start on one thread.
+                // The queues belong to this loop and are shared by the
+                // MFIters of its threads, so that nested and concurrent
+                // loops have their own.
+                std::shared_ptr<StealQueue> queues;
+#pragma omp single copyprivate(queues)
+                {
+                    queues.reset(new StealQueue[nthreads], std::default_delete<StealQueue[]>());
+                    StealQueue* steal_queues = queues.get();
+                    const int ntot = endIndex - beginIndex;
+                    const bool snap = ntot > 0 && (*local_index_map)[endIndex-1]
+                        - (*local_index_map)[beginIndex] + 1 >= nthreads;
+                    int b = beginIndex;
+                    for (int t = 0; t < nthreads; ++t) {
+                        int e = endIndex;
+                        if (t < nthreads-1) {
+                            e = std::max(b, beginIndex + static_cast<int>((Long(t+1)*ntot)/nthreads));
+                            if (snap) {
+                                while (e > b && e < endIndex &&
+                                       (*local_index_map)[e] == (*local_index_map)[e-1]) {
+                                    --e;
+                                }
+                            }
+                        }
+                        steal_queues[t].head = b;
+                        steal_queues[t].tail = e;
+                        b = e;
+                    }
+                }
+                m_steal_queues = std::move(queues);
+                m_steal_nqueues = nthreads;
+                currentIndex = nextStolenIndex();
+            }
+            else if (dynamic)
             {
                 beginIndex = omp_get_thread_num();
             }
@@ -325,7 +394,7 @@ MFIter::Initialize ()
 	}
 #endif
 
-	currentIndex = beginIndex;
+	if (!work_stealing) currentIndex = beginIndex;
 
 #ifdef AMREX_USE_GPU
 	Gpu::Device::setStreamIndex((streams > 0) ? currentIndex%streams : -1);
@@ -338,7 +407,16 @@ MFIter::Initialize ()
 #endif
 
 	typ = fabArray.boxArray().ixType();
+
+        if (m_cost) {
+            AMREX_ASSERT(m_cost->DistributionMap() == fabArray.DistributionMap());
+            if (isValid()) startCost();
+        }
     }
+
+#ifdef AMREX_TINY_PROFILING
+    TinyProfiler::TraceBox(isValid() ? index() : m_prev_trace_box);
+#endif
 }
 
 Box 
@@ -481,8 +559,14 @@ MFIter::grownnodaltilebox (int dir, IntVect const& a_ng) const noexcept
 void
 MFIter::operator++ () noexcept
 {
+    if (m_cost && isValid()) stopCost();
+
 #ifdef _OPENMP
-    if (dynamic)
+    if (work_stealing)
+    {
+        currentIndex = nextStolenIndex();
+    }
+    else if (dynamic)
     {
 #pragma omp atomic capture
         currentIndex = nextDynamicIndex++;
@@ -514,6 +598,65 @@ MFIter::operator++ () noexcept
         }
 #endif
     }
+
+    if (m_cost && isValid()) startCost();
+
+#ifdef AMREX_TINY_PROFILING
+    TinyProfiler::TraceBox(isValid() ? index() : m_prev_trace_box);
+#endif
+}
+
+int
+MFIter::nextStolenIndex () noexcept
+{
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    StealQueue* steal_queues = m_steal_queues.get();
+    StealQueue& q = steal_queues[tid];
+    {
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.head < q.tail) return q.head++;
+    }
+    for (int i = 1; i < m_steal_nqueues; ++i)
+    {
+        StealQueue& v = steal_queues[(tid+i)%m_steal_nqueues];
+        int b, e;
+        {
+            std::lock_guard<std::mutex> lock(v.mtx);
+            const int nleft = v.tail - v.head;
+            if (nleft <= 0) continue;
+            e = v.tail;
+            b = e - (nleft+1)/2;
+            v.tail = b;
+        }
+        std::lock_guard<std::mutex> lock(q.mtx);
+        q.head = b+1;
+        q.tail = e;
+        return b;
+    }
+#endif
+    return endIndex;
+}
+
+void
+MFIter::startCost () noexcept
+{
+    m_cost_t0 = ParallelDescriptor::second();
+}
+
+void
+MFIter::stopCost () noexcept
+{
+#ifdef AMREX_USE_GPU
+    // Kernels are asynchronous, so wait for them to be counted.
+    if (Gpu::inLaunchRegion()) Gpu::streamSynchronize();
+#endif
+    const Real dt = static_cast<Real>(ParallelDescriptor::second() - m_cost_t0);
+    Real& c = (*m_cost)[*this];
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    c += dt;
 }
 
 #ifdef AMREX_USE_GPU_PRAGMA
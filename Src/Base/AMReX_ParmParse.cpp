@@ -13,6 +13,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <unordered_map>
 
 #include <AMReX.H>
 #include <AMReX_ParmParse.H>
@@ -195,6 +196,55 @@ ParmParse::Table g_table;
 typedef std::list<ParmParse::PP_entry>::iterator list_iterator;
 typedef std::list<ParmParse::PP_entry>::const_iterator const_list_iterator;
 
+//
+// The entries of a table are indexed by name so that lookups do not have
+// to scan the whole table.  The indices are built lazily and are all
+// thrown away whenever the table changes.
+//
+typedef std::vector<const ParmParse::PP_entry*> EntryList;
+typedef std::unordered_map<std::string,EntryList> TableIndex;
+
+long g_table_generation = 0;
+long g_index_generation = -1;
+std::unordered_map<const ParmParse::Table*,TableIndex> g_index;
+
+void
+table_changed ()
+{
+    ++g_table_generation;
+}
+
+//
+// Return the entries of a table with the given name in table order,
+// or 0 if there are none.
+//
+const EntryList*
+ppentries (const ParmParse::Table& table, const std::string& name)
+{
+    const TableIndex* index;
+#ifdef _OPENMP
+#pragma omp critical (amrex_parmparse_index)
+#endif
+    {
+        if ( g_index_generation != g_table_generation )
+        {
+            g_index.clear();
+            g_index_generation = g_table_generation;
+        }
+        auto r = g_index.emplace(&table, TableIndex());
+        if ( r.second )
+        {
+            for ( const_list_iterator li = table.begin(), End = table.end(); li != End; ++li )
+            {
+                r.first->second[li->m_name].push_back(&*li);
+            }
+        }
+        index = &(r.first->second);
+    }
+    auto it = index->find(name);
+    return (it == index->end()) ? 0 : &(it->second);
+}
+
 template <class T> const char* tok_name(const T&) { return typeid(T).name(); }
 template <class T> const char* tok_name(std::vector<T>&) { return tok_name(T());}
 
@@ -405,39 +455,35 @@ ppindex (const ParmParse::Table& table,
 	 const std::string& name,
 	 bool recordQ)
 {
+    const EntryList* entries = ppentries(table, name);
+    if ( entries == 0 )
+    {
+        return 0;
+    }
+
     const ParmParse::PP_entry* fnd = 0;
 
     if ( n == ParmParse::LAST )
     {
-        //
-        // Search from back of list.
-        //
-        for (std::list<ParmParse::PP_entry>::const_reverse_iterator li = table.rbegin(), REnd = table.rend(); li != REnd; ++li)
+        for (EntryList::const_reverse_iterator li = entries->rbegin(), REnd = entries->rend(); li != REnd; ++li)
         {
-            if ( ppfound(name, *li, recordQ) )
+            if ( ppfound(name, **li, recordQ) )
             {
-                fnd = &*li;
+                fnd = *li;
                 break;
             }
         }
     }
     else
     {
-        for ( const_list_iterator li =table.begin(), End = table.end(); li != End; ++li )
+        for ( EntryList::const_iterator li = entries->begin(), End = entries->end(); li != End; ++li )
         {
-            if ( ppfound(name, *li, recordQ) )
+            if ( ppfound(name, **li, recordQ) && n-- == 0 )
             {
-                fnd = &*li;
-                if ( --n < 0 )
-		{
-                    break;
-		}
+                fnd = *li;
+                break;
             }
         }
-        if ( n >= 0)
-	{
-            fnd = 0;
-	}
     }
 
     if ( fnd )
@@ -445,11 +491,11 @@ ppindex (const ParmParse::Table& table,
         //
         // Found an entry; mark all occurences of name as used.
         //
-        for ( const_list_iterator li = table.begin(), End = table.end(); li != End; ++li )
+        for ( EntryList::const_iterator li = entries->begin(), End = entries->end(); li != End; ++li )
 	{
-            if ( ppfound(name, *li, recordQ) )
+            if ( ppfound(name, **li, recordQ) )
 	    {
-                li->m_queried = true;
+                (*li)->m_queried = true;
 	    }
 	}
     }
@@ -851,6 +897,7 @@ saddval (const std::string&      name,
 	ParmParse::PP_entry entry(name,val.str());
 	entry.m_queried=true;
 	g_table.push_back(entry);
+	table_changed();
 }
 
 
@@ -868,6 +915,7 @@ saddarr (const std::string&      name,
 	ParmParse::PP_entry entry(name,arr);
 	entry.m_queried=true;
 	g_table.push_back(entry);
+	table_changed();
 }
 
 }
@@ -905,6 +953,7 @@ ppinit (int argc, char** argv, const char* parfile, ParmParse::Table& table)
         //
         g_table.splice(table.end(), arg_table);
     }
+    table_changed();
     initialized = true;
 }
 
@@ -1010,6 +1059,7 @@ void
 ParmParse::appendTable(ParmParse::Table& tab)
 {
   g_table.splice(g_table.end(), tab);
+  table_changed();
 }
 
 static
@@ -1109,6 +1159,7 @@ ParmParse::Finalize ()
       if (amrex::system::abort_on_unused_inputs) amrex::Abort("ERROR: unused ParmParse variables.");
     }
     g_table.clear();
+    table_changed();
 
 #if !defined(BL_NO_FORT)
     amrex_finalize_namelist();
@@ -1891,32 +1942,37 @@ ParmParse::addarr (const char* name,
 // Return number of occurences of parameter name.
 //
 
+static
 int
-ParmParse::countname (const std::string& name) const
+ppcount (const ParmParse::Table& table,
+         const std::string& name,
+         bool recordQ)
 {
     int cnt = 0;
-    for ( const_list_iterator li = m_table.begin(), End = m_table.end(); li != End; ++li )
+    const EntryList* entries = ppentries(table, name);
+    if ( entries )
     {
-	if ( ppfound(prefixedName(name), *li, false) )
-	{
-	    cnt++;
-	}
+        for ( EntryList::const_iterator li = entries->begin(), End = entries->end(); li != End; ++li )
+        {
+            if ( ppfound(name, **li, recordQ) )
+            {
+                cnt++;
+            }
+        }
     }
     return cnt;
 }
 
+int
+ParmParse::countname (const std::string& name) const
+{
+    return ppcount(m_table, prefixedName(name), false);
+}
+
 int
 ParmParse::countRecords (const std::string& name) const
 {
-    int cnt = 0;
-    for ( const_list_iterator li = m_table.begin(), End = m_table.end(); li != End; ++li )
-    {
-	if ( ppfound(prefixedName(name), *li, true) )
-	{
-	    cnt++;
-	}
-    }
-    return cnt;
+    return ppcount(m_table, prefixedName(name), true);
 }
 
 //
@@ -1926,24 +1982,26 @@ ParmParse::countRecords (const std::string& name) const
 bool
 ParmParse::contains (const char* name) const
 {
-    for ( const_list_iterator li = m_table.begin(), End = m_table.end(); li != End; ++li )
+    //
+    // Marks all occurences of name as used if found.
+    //
+    return ppindex(m_table, FIRST, prefixedName(name), false) != 0;
+}
+
+bool
+ParmParse::Snapshot::update ()
+{
+    if ( m_generation == g_table_generation )
     {
-       if ( ppfound(prefixedName(name), *li, false))
-       {
-           //
-           // Found an entry; mark all occurences of name as used.
-           //
-           for ( const_list_iterator lli = m_table.begin(); lli != m_table.end(); ++lli )
-	   {
-               if ( ppfound(prefixedName(name), *lli, false) )
-	       {
-                   lli->m_queried = true;
-	       }
-	   }
-           return true;
-       }
+        return false;
     }
-    return false;
+    ParmParse pp(m_prefix);
+    for ( auto const& q : m_queries )
+    {
+        q(pp);
+    }
+    m_generation = g_table_generation;
+    return true;
 }
 
 ParmParse::Record
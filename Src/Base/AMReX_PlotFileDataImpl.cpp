@@ -78,11 +78,11 @@ PlotFileDataImpl::PlotFileDataImpl (std::string const& plotfile_name)
         Real gtime;
         is >> levtmp >> ngrids >> gtime;
         is >> levsteptmp;
-        Real glo[3], ghi[3];
-        for (int igrid = 0; igrid < ngrids; ++igrid) {
-            for (int idim = 0; idim < m_spacedim; ++idim) {
-                is >> glo[idim] >> ghi[idim];
-            }
+        // The physical locations of the grids, one line per direction, are
+        // not needed, and are slow to parse when there are many grids.
+        GotoNextLine(is);
+        for (Long i = 0, nlines = Long(ngrids)*m_spacedim; i < nlines; ++i) {
+            GotoNextLine(is);
         }
         std::string relname;
         is >> relname;
@@ -123,23 +123,41 @@ PlotFileDataImpl::get (int level) noexcept
     return mf;
 }
 
-MultiFab
-PlotFileDataImpl::get (int level, std::string const& varname) noexcept
+int
+PlotFileDataImpl::varIndex (std::string const& varname) const
 {
-    MultiFab mf(m_ba[level], m_dmap[level], 1, m_ngrow[level]);
     auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
     if (r == std::end(m_var_names)) {
         amrex::Abort("PlotFileDataImpl::get: varname not found "+varname);
-    } else {
-        int icomp = std::distance(std::begin(m_var_names), r);
-        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-            int gid = mfi.index();
-            FArrayBox& dstfab = mf[mfi];
-            std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
-            dstfab.copy<RunOn::Host>(*srcfab);
-        }
+    }
+    return std::distance(std::begin(m_var_names), r);
+}
+
+MultiFab
+PlotFileDataImpl::get (int level, std::string const& varname) noexcept
+{
+    MultiFab mf(m_ba[level], m_dmap[level], 1, m_ngrow[level]);
+    int icomp = varIndex(varname);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        int gid = mfi.index();
+        FArrayBox& dstfab = mf[mfi];
+        std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
+        dstfab.copy<RunOn::Host>(*srcfab);
     }
     return mf;
 }
 
+FArrayBox
+PlotFileDataImpl::get (int level, Box const& region, std::string const& varname)
+{
+    int icomp = varIndex(varname);
+    FArrayBox fab(region, 1);
+    fab.setVal<RunOn::Host>(0.0);
+    for (auto const& is : m_ba[level].intersections(region)) {
+        m_vismf[level]->ReadFabRegion(is.first, icomp, is.second, fab);
+    }
+    m_vismf[level]->ReleaseMappedFiles();
+    return fab;
+}
+
 }
@@ -240,7 +240,10 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
             } else {
                 data = mf[level];
             }
+            const FabCodec::Type codec = VisMF::GetCompression();
+            VisMF::SetCompression(VisMF::GetPlotfileCompression());
             VisMF::Write(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix));
+            VisMF::SetCompression(codec);
         }
     }
 }
@@ -454,7 +457,10 @@ EB_WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
         MultiFab::Copy(mf_tmp, *mf[level], 0, 0, nc, 0);
         auto const& factory = dynamic_cast<EBFArrayBoxFactory const&>(mf[level]->Factory());
         MultiFab::Copy(mf_tmp, factory.getVolFrac(), 0, nc, 1, 0);
+        const FabCodec::Type codec = VisMF::GetCompression();
+        VisMF::SetCompression(VisMF::GetPlotfileCompression());
 	VisMF::Write(mf_tmp, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix));
+        VisMF::SetCompression(codec);
     }
 
 //    VisMF::SetNOutFiles(saveNFiles);
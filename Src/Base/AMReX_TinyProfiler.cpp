@@ -5,6 +5,10 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <set>
 
 #include <AMReX_TinyProfiler.H>
@@ -12,6 +16,7 @@
 #include <AMReX_ParallelReduce.H>
 #include <AMReX_Utility.H>
 #include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
 
 #ifdef AMREX_USE_CUPTI
 #include <AMReX_CuptiTrace.H>
@@ -25,36 +30,45 @@
 
 namespace amrex {
 
-std::vector<std::string>          TinyProfiler::regionstack;
-std::deque<std::tuple<double,double,std::string*> > TinyProfiler::ttstack;
-std::map<std::string,std::map<std::string, TinyProfiler::Stats> > TinyProfiler::statsmap;
 double TinyProfiler::t_init = std::numeric_limits<double>::max();
+std::vector<std::unique_ptr<TinyProfiler::ThreadData> > TinyProfiler::all_threads;
+bool TinyProfiler::tracing = false;
+Long TinyProfiler::trace_buffer_size = 1L << 18;
+std::string TinyProfiler::trace_file = "trace";
 
 namespace {
-    std::set<std::string> improperly_nested_timers;
     static constexpr char mainregion[] = "main";
+    bool initialized = false;
+
+    // Global table of interned names.  The deque keeps the strings in
+    // place, so pointers to them stay valid.
+    std::mutex names_mutex;
+    std::deque<std::string> names;
+    std::unordered_map<std::string,int> name_ids;
+
+    std::mutex threads_mutex;
 }
 
 TinyProfiler::TinyProfiler (std::string funcname) noexcept
-    : fname(std::move(funcname)), uCUPTI(false)
+    : fid(intern(funcname, fname)), uCUPTI(false)
 {
     start();
 }
 
 TinyProfiler::TinyProfiler (std::string funcname, bool start_, bool useCUPTI) noexcept
-    : fname(std::move(funcname)), uCUPTI(useCUPTI)
+    : fid(intern(funcname, fname)), uCUPTI(useCUPTI)
 {
     if (start_) start();
 }
 
 TinyProfiler::TinyProfiler (const char* funcname) noexcept
-    : fname(funcname), uCUPTI(false)
+    : fid(intern(funcname, fname)), uCUPTI(false)
 {
     start();
 }
 
 TinyProfiler::TinyProfiler (const char* funcname, bool start_, bool useCUPTI) noexcept
-    : fname(funcname), uCUPTI(useCUPTI)
+    : fid(intern(funcname, fname)), uCUPTI(useCUPTI)
 {
     if (start_) start();
 }
@@ -64,15 +78,148 @@ TinyProfiler::~TinyProfiler ()
     stop();
 }
 
+TinyProfiler::ThreadData&
+TinyProfiler::threadData ()
+{
+    static thread_local ThreadData* td = nullptr;
+    if (td == nullptr) {
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        all_threads.emplace_back(new ThreadData());
+        td = all_threads.back().get();
+        td->tid = all_threads.size()-1;
+        if (initialized) {
+            const std::string* p;
+            td->regionstack.push_back(internName(mainregion, p));
+        }
+    }
+    return *td;
+}
+
+int
+TinyProfiler::internName (const std::string& name, const std::string*& p)
+{
+    std::lock_guard<std::mutex> lock(names_mutex);
+    auto r = name_ids.insert(std::make_pair(name, static_cast<int>(names.size())));
+    if (r.second) names.push_back(name);
+    p = &names[r.first->second];
+    return r.first->second;
+}
+
+int
+TinyProfiler::intern (const char* name, const std::string*& p)
+{
+    // Most names are string literals, so the pointer is usually enough to
+    // find them.  The name is compared too in case the buffer was reused.
+    auto& cache = threadData().ptrcache;
+    auto it = cache.find(name);
+    if (it != cache.end() && std::strcmp(it->second.second->c_str(), name) == 0) {
+        p = it->second.second;
+        return it->second.first;
+    }
+    int id = internName(name, p);
+    cache[name] = std::make_pair(id, p);
+    return id;
+}
+
+int
+TinyProfiler::intern (const std::string& name, const std::string*& p)
+{
+    auto& cache = threadData().strcache;
+    auto it = cache.find(name);
+    if (it != cache.end()) {
+        p = it->second.second;
+        return it->second.first;
+    }
+    int id = internName(name, p);
+    cache.insert(std::make_pair(name, std::make_pair(id, p)));
+    return id;
+}
+
+TinyProfiler::Stats&
+TinyProfiler::ThreadData::getStats (int region, int f)
+{
+    if (region >= static_cast<int>(statstable.size())) {
+        statstable.resize(region+1);
+    }
+    auto& row = statstable[region];
+    if (f >= static_cast<int>(row.size())) {
+        row.resize(f+1, nullptr);
+    }
+    if (row[f] == nullptr) {
+        statspool.emplace_back();
+        row[f] = &statspool.back();
+    }
+    return *row[f];
+}
+
+void
+TinyProfiler::ThreadData::record (double t, int name, int box, Long bytes, char ph)
+{
+    if (trace.empty()) {
+        trace.resize(std::max(trace_buffer_size, Long(1)));
+    }
+    TraceEvent& ev = trace[ntrace % static_cast<Long>(trace.size())];
+    ev.t = t;
+    ev.name = name;
+    ev.box = box;
+    ev.bytes = bytes;
+    ev.ph = ph;
+    ++ntrace;
+}
+
+void
+TinyProfiler::TraceMessage (const char* name, Long bytes, int peer) noexcept
+{
+    if (tracing) {
+        const std::string* p;
+        int id = intern(name, p);
+        threadData().record(amrex::second(), id, peer, bytes, 'i');
+    }
+}
+
+void
+TinyProfiler::addStats (Stats* st)
+{
+    if (nstats < max_inline_stats) {
+        stats[nstats] = st;
+    } else {
+        stats_extra.push_back(st);
+    }
+    ++nstats;
+}
+
+void
+TinyProfiler::stopStats (double dtin, double dtex, int nKernelCalls)
+{
+    for (int i = 0; i < nstats; ++i)
+    {
+        Stats* st = (i < max_inline_stats) ? stats[i] : stats_extra[i-max_inline_stats];
+        --(st->depth);
+        ++(st->n);
+        if (st->depth == 0) {
+            st->dtin += dtin;
+        }
+        st->dtex += dtex;
+        st->usesCUPTI = uCUPTI;
+        if (uCUPTI) {
+            st->nk += nKernelCalls;
+        }
+    }
+    nstats = 0;
+    stats_extra.clear();
+}
+
 void
 TinyProfiler::start () noexcept
 {
 #ifdef _OPENMP
 #pragma omp master
 #endif
-    if (stats.empty() && !regionstack.empty())
     {
-        double t;
+    ThreadData& td = threadData();
+    if (nstats == 0 && !td.regionstack.empty())
+    {
+        double t = 0.0;
 	if (!uCUPTI) {
 	    t = amrex::second();
 	} else {
@@ -84,20 +231,23 @@ TinyProfiler::start () noexcept
 #endif
 	}
 
-	ttstack.emplace_back(std::make_tuple(t, 0.0, &fname));
-	global_depth = ttstack.size();
+	td.ttstack.emplace_back(std::make_tuple(t, 0.0, fname));
+	global_depth = td.ttstack.size();
+
+        if (tracing) td.record(t, fid, td.trace_box, -1, 'B');
 
 #ifdef AMREX_USE_CUDA
-	nvtxRangePush(fname.c_str());
+	nvtxRangePush(fname->c_str());
 #endif
 
-        for (auto const& region : regionstack)
+        for (int region : td.regionstack)
         {
-            Stats& st = statsmap[region][fname];
+            Stats& st = td.getStats(region, fid);
             ++st.depth;
-            stats.push_back(&st);
+            addStats(&st);
         }
     }
+    }
 }
 
 void
@@ -106,8 +256,9 @@ TinyProfiler::stop () noexcept
 #ifdef _OPENMP
 #pragma omp master
 #endif
-    if (!stats.empty()) 
+    if (nstats > 0)
     {
+        ThreadData& td = threadData();
         double t;
 	int nKernelCalls = 0;
 #ifdef AMREX_USE_CUPTI
@@ -122,13 +273,15 @@ TinyProfiler::stop () noexcept
 	    t = amrex::second();
         }
 
-	while (static_cast<int>(ttstack.size()) > global_depth) {
-	    ttstack.pop_back();
+        if (tracing) td.record(uCUPTI ? amrex::second() : t, fid, td.trace_box, -1, 'E');
+
+	while (static_cast<int>(td.ttstack.size()) > global_depth) {
+	    td.ttstack.pop_back();
 	};
 
-	if (static_cast<int>(ttstack.size()) == global_depth)
+	if (static_cast<int>(td.ttstack.size()) == global_depth)
 	{
-	    const std::tuple<double,double,std::string*>& tt = ttstack.back();
+	    const auto& tt = td.ttstack.back();
 
 	    // first: wall time when the pair is pushed into the stack
 	    // second: accumulated dt of children
@@ -142,34 +295,22 @@ TinyProfiler::stop () noexcept
 	        dtex = dtin - std::get<1>(tt); 
 	    }
 
-        for (Stats* st : stats)
-        {
-            --(st->depth);
-            ++(st->n);
-            if (st->depth == 0) {
-                st->dtin += dtin;
-            }
-            st->dtex += dtex;
-            st->usesCUPTI = uCUPTI;
-            if (uCUPTI) {
-                st->nk += nKernelCalls;
-            }
-        }
+            stopStats(dtin, dtex, nKernelCalls);
 
-        ttstack.pop_back();
-        if (!ttstack.empty()) {
-            std::tuple<double,double,std::string*>& parent = ttstack.back();
-            std::get<1>(parent) += dtin;
-        }
+            td.ttstack.pop_back();
+            if (!td.ttstack.empty()) {
+                auto& parent = td.ttstack.back();
+                std::get<1>(parent) += dtin;
+            }
 
 #ifdef AMREX_USE_CUDA
-        nvtxRangePop();
+            nvtxRangePop();
 #endif
 	} else {
-	    improperly_nested_timers.insert(fname);
+	    td.improperly_nested_timers.insert(fid);
+            nstats = 0;
+            stats_extra.clear();
 	}
-
-    stats.clear();
     }
 }
 
@@ -180,8 +321,9 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
 #ifdef _OPENMP
 #pragma omp master
 #endif
-    if (!stats.empty()) 
+    if (nstats > 0)
     {
+        ThreadData& td = threadData();
         double t;
         cudaDeviceSynchronize();
         cuptiActivityFlushAll(0);
@@ -193,14 +335,16 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
             record->setUintID(boxUintID);
         }
 
-        while (static_cast<int>(ttstack.size()) > global_depth) 
+        if (tracing) td.record(amrex::second(), fid, td.trace_box, -1, 'E');
+
+        while (static_cast<int>(td.ttstack.size()) > global_depth) 
         {
-            ttstack.pop_back();
+            td.ttstack.pop_back();
         };
 
-        if (static_cast<int>(ttstack.size()) == global_depth)
+        if (static_cast<int>(td.ttstack.size()) == global_depth)
         {
-            const std::tuple<double,double,std::string*>& tt = ttstack.back();
+            const auto& tt = td.ttstack.back();
 
             // first: wall time when the pair is pushed into the stack
             // second: accumulated dt of children
@@ -210,23 +354,12 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
             dtin = t;
             dtex = dtin - std::get<1>(tt); 
 
-            for (Stats* st : stats)
-            {
-                --(st->depth);
-                ++(st->n);
-                if (st->depth == 0) 
-                {
-                    st->dtin += dtin;
-                }
-                st->dtex += dtex;
-                st->usesCUPTI = uCUPTI;
-                st->nk += nKernelCalls;		
-            }
+            stopStats(dtin, dtex, nKernelCalls);
 
-            ttstack.pop_back();
-            if (!ttstack.empty()) 
+            td.ttstack.pop_back();
+            if (!td.ttstack.empty()) 
             {
-                std::tuple<double,double,std::string*>& parent = ttstack.back();
+                auto& parent = td.ttstack.back();
                 std::get<1>(parent) += dtin;
             }
 
@@ -235,10 +368,10 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
 #endif
         } else 
         {
-            improperly_nested_timers.insert(fname);
+            td.improperly_nested_timers.insert(fid);
+            nstats = 0;
+            stats_extra.clear();
         }
-
-        stats.clear();
     }
 }
 #endif
@@ -246,7 +379,22 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
 void
 TinyProfiler::Initialize () noexcept
 {
-    regionstack.push_back(mainregion);
+    {
+        ParmParse pp("tiny_profiler");
+        pp.query("trace", tracing);
+        pp.query("trace_file", trace_file);
+        pp.query("trace_buffer_size", trace_buffer_size);
+    }
+
+    initialized = true;
+    const std::string* p;
+    int main_id = internName(mainregion, p);
+    ThreadData& td = threadData();
+    if (td.regionstack.empty()) {
+        td.regionstack.push_back(main_id);
+    }
+    // Trace events are relative to t_init, so start all processes together.
+    if (tracing) ParallelDescriptor::Barrier();
     t_init = amrex::second();
 }
 
@@ -264,8 +412,33 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
 
     double t_final = amrex::second();
 
-    // make a local copy so that any functions call after this will not be recorded in the local copy.
-    auto lstatsmap = statsmap;
+    if (tracing) WriteTrace();
+
+    // Merge the timers of all threads into a local copy, so that any
+    // functions called after this will not be recorded in it.
+    std::map<std::string,std::map<std::string,Stats> > lstatsmap;
+    std::set<std::string> improperly_nested_timers;
+    {
+        std::lock_guard<std::mutex> tlock(threads_mutex);
+        std::lock_guard<std::mutex> nlock(names_mutex);
+        for (auto const& td : all_threads) {
+            for (int r = 0; r < static_cast<int>(td->statstable.size()); ++r) {
+                const auto& row = td->statstable[r];
+                for (int f = 0; f < static_cast<int>(row.size()); ++f) {
+                    if (row[f] == nullptr) continue;
+                    Stats& st = lstatsmap[names[r]][names[f]];
+                    st.n += row[f]->n;
+                    st.dtin += row[f]->dtin;
+                    st.dtex += row[f]->dtex;
+                    st.usesCUPTI = st.usesCUPTI || row[f]->usesCUPTI;
+                    st.nk += row[f]->nk;
+                }
+            }
+            for (int f : td->improperly_nested_timers) {
+                improperly_nested_timers.insert(names[f]);
+            }
+        }
+    }
 
     bool properly_nested = improperly_nested_timers.size() == 0;
     ParallelDescriptor::ReduceBoolAnd(properly_nested);
@@ -538,15 +711,21 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
 void
 TinyProfiler::StartRegion (std::string regname) noexcept
 {
-    if (std::find(regionstack.begin(), regionstack.end(), regname) == regionstack.end()) {
-        regionstack.emplace_back(std::move(regname));
+    const std::string* p;
+    int id = intern(regname, p);
+    auto& regionstack = threadData().regionstack;
+    if (std::find(regionstack.begin(), regionstack.end(), id) == regionstack.end()) {
+        regionstack.push_back(id);
     }
 }
 
 void
 TinyProfiler::StopRegion (const std::string& regname) noexcept
 {
-    if (regname == regionstack.back()) {
+    const std::string* p;
+    int id = intern(regname, p);
+    auto& regionstack = threadData().regionstack;
+    if (!regionstack.empty() && id == regionstack.back()) {
         regionstack.pop_back();
     }
 }
@@ -577,9 +756,72 @@ void
 TinyProfiler::PrintCallStack (std::ostream& os)
 {
     os << "===== TinyProfilers ======\n";
-    for (auto const& x : ttstack) {
+    for (auto const& x : threadData().ttstack) {
         os << *(std::get<2>(x)) << "\n";
     }
 }
 
+void
+TinyProfiler::WriteTrace ()
+{
+    const int myproc = ParallelDescriptor::MyProc();
+    const std::string filename = amrex::Concatenate(trace_file+".", myproc, 5) + ".json";
+    std::ofstream ofs(filename);
+    if (!ofs.good()) {
+        amrex::Warning("TinyProfiler: failed to open " + filename);
+        return;
+    }
+
+    auto escape = [] (const std::string& name) -> std::string
+    {
+        std::string r;
+        for (char c : name) {
+            if (c == '"' || c == '\\') r += '\\';
+            r += c;
+        }
+        return r;
+    };
+
+    ofs << std::fixed << std::setprecision(3);
+    ofs << "{\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << myproc
+        << ",\"args\":{\"name\":\"rank " << myproc << "\"}}";
+
+    std::lock_guard<std::mutex> tlock(threads_mutex);
+    std::lock_guard<std::mutex> nlock(names_mutex);
+    for (auto const& td : all_threads)
+    {
+        if (td->ntrace == 0) continue;
+
+        ofs << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << myproc
+            << ",\"tid\":" << td->tid << ",\"args\":{\"name\":\"thread " << td->tid << "\"}}";
+
+        const Long size = td->trace.size();
+        const Long first = std::max(td->ntrace - size, Long(0));
+        // Once the buffer has wrapped around, the oldest end events may
+        // have lost their begin events.
+        int depth = 0;
+        for (Long i = first; i < td->ntrace; ++i)
+        {
+            const TraceEvent& ev = td->trace[i % size];
+            if (ev.ph == 'E') {
+                if (depth == 0) continue;
+                --depth;
+            } else if (ev.ph == 'B') {
+                ++depth;
+            }
+            ofs << ",\n{\"name\":\"" << escape(names[ev.name]) << "\",\"ph\":\"" << ev.ph
+                << "\",\"ts\":" << (ev.t-t_init)*1.e6
+                << ",\"pid\":" << myproc << ",\"tid\":" << td->tid;
+            if (ev.ph == 'i') {
+                ofs << ",\"s\":\"t\",\"args\":{\"bytes\":" << ev.bytes << ",\"peer\":" << ev.box << "}";
+            } else if (ev.box >= 0) {
+                ofs << ",\"args\":{\"box\":" << ev.box << "}";
+            }
+            ofs << "}";
+        }
+    }
+    ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
 }
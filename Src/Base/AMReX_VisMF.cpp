@@ -6,6 +6,7 @@
 #include <cerrno>
 #include <atomic>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 #include <array>
 #include <memory>
@@ -20,9 +21,17 @@
 #include <AMReX_FabArrayUtility.H>
 #include <AMReX_AsyncOut.H>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace amrex {
 
 static const char *TheMultiFabHdrFileSuffix = "_H";
+static const char *TheMultiFabBinaryIndexSuffix = "_HB";
 static const char *FabFileSuffix = "_D_";
 static const char *TheFabOnDiskPrefix = "FabOnDisk:";
 
@@ -39,6 +48,11 @@ bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
+FabCodec::Type VisMF::compression(FabCodec::None);
+FabCodec::Type VisMF::plotfileCompression(FabCodec::None);
+bool VisMF::binaryIndex(false);
+Vector<Real> VisMF::lossyAbsTol;
+Vector<Real> VisMF::lossyRelTol;
 
 Long VisMF::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -51,6 +65,196 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    // ---- whichComp == -1 decompresses all components
+    void decompressFAB (const char *buffer, Long nbytes, int ncomp,
+                        FArrayBox &fab, int whichComp)
+    {
+        const Long npts(fab.box().numPts());
+        Long pos(0);
+        for(int n(0); n < ncomp; ++n) {
+            Long compBytes(-1);
+            if(pos + Long(sizeof(Long)) <= nbytes) {
+                std::memcpy(&compBytes, buffer + pos, sizeof(Long));
+                pos += sizeof(Long);
+            }
+            if(compBytes < 0 || pos + compBytes > nbytes) {
+                amrex::Error("VisMF: corrupt compressed FAB");
+            }
+            if(whichComp == -1 || whichComp == n) {
+                Real *dst = fab.dataPtr(whichComp == -1 ? n : 0);
+                FabCodec::Decompress(buffer + pos, compBytes, dst, npts);
+            }
+            pos += compBytes;
+        }
+    }
+
+    void readCompressedFAB (std::istream &is, Long nbytes, int ncomp,
+                            FArrayBox &fab, int whichComp)
+    {
+        Vector<char> buffer(nbytes);
+        is.read(buffer.dataPtr(), nbytes);
+        if( ! is.good()) {
+            amrex::Error("VisMF: failed to read compressed FAB");
+        }
+        decompressFAB(buffer.dataPtr(), nbytes, ncomp, fab, whichComp);
+    }
+
+    // ---- The binary index starts with these bytes and a format number.
+    // ---- The sizes of int, Long and Real and the dimension follow, and
+    // ---- an index written with different ones is not used.
+    const char binaryIndexMagic[8] = {'V','i','s','M','F','I','d','x'};
+    const int binaryIndexFormat = 2;
+
+    template <class T>
+    void putBinary (std::ostream &os, const T &v)
+    {
+        os.write(reinterpret_cast<const char *>(&v), sizeof(T));
+    }
+
+    void putBinary (std::ostream &os, const std::string &str)
+    {
+        putBinary(os, static_cast<int>(str.size()));
+        os.write(str.data(), str.size());
+    }
+
+    struct BinaryReader
+    {
+        BinaryReader (const char *pos, const char *end) : m_pos(pos), m_end(end) {}
+
+        const char *m_pos;
+        const char *m_end;
+        bool m_ok = true;
+
+        template <class T>
+        T get ()
+        {
+            T v{};
+            if(m_end - m_pos < Long(sizeof(T))) {
+                m_ok = false;
+            } else {
+                std::memcpy(&v, m_pos, sizeof(T));
+                m_pos += sizeof(T);
+            }
+            return v;
+        }
+
+        std::string getString ()
+        {
+            int n(get<int>());
+            if( ! m_ok || n < 0 || m_end - m_pos < n) {
+                m_ok = false;
+                return std::string();
+            }
+            std::string str(m_pos, n);
+            m_pos += n;
+            return str;
+        }
+    };
+
+    bool readBinaryIndex (const char *buf, Long nbytes, Long hdrBytes, VisMF::Header &hd)
+    {
+        BinaryReader br(buf, buf + nbytes);
+        for(int i(0); i < 8; ++i) {
+            if(br.get<char>() != binaryIndexMagic[i]) {
+                return false;
+            }
+        }
+        if(br.get<int>() != binaryIndexFormat ||
+           br.get<int>() != int(sizeof(int))  ||
+           br.get<int>() != int(sizeof(Long)) ||
+           br.get<int>() != int(sizeof(Real)) ||
+           br.get<int>() != AMREX_SPACEDIM)
+        {
+            return false;
+        }
+        // ---- the index mirrors an ASCII header of this size
+        if(br.get<Long>() != hdrBytes) {
+            return false;
+        }
+
+        hd.m_vers  = br.get<int>();
+        hd.m_how   = static_cast<VisMF::How>(br.get<int>());
+        hd.m_ncomp = br.get<int>();
+        IntVect typ;
+        for(int idim(0); idim < AMREX_SPACEDIM; ++idim) {
+            hd.m_ngrow[idim] = br.get<int>();
+            typ[idim] = br.get<int>();
+        }
+
+        const Long nboxes(br.get<Long>());
+        if( ! br.m_ok || nboxes < 0 || nboxes > nbytes) {
+            return false;
+        }
+        const IndexType ixtyp(typ);
+        BoxList bl(ixtyp);
+        bl.reserve(nboxes);
+        for(Long i(0); i < nboxes; ++i) {
+            IntVect lo, hi;
+            for(int idim(0); idim < AMREX_SPACEDIM; ++idim) {
+                lo[idim] = br.get<int>();
+                hi[idim] = br.get<int>();
+            }
+            bl.push_back(Box(lo, hi, ixtyp));
+        }
+        if( ! br.m_ok) {
+            return false;
+        }
+        hd.m_ba = BoxArray(std::move(bl));
+
+        const int nfiles(br.get<int>());
+        if( ! br.m_ok || nfiles < 0 || nfiles > nbytes) {
+            return false;
+        }
+        Vector<std::string> fileNames(nfiles);
+        for(int i(0); i < nfiles; ++i) {
+            fileNames[i] = br.getString();
+        }
+        hd.m_fod.resize(nboxes);
+        for(Long i(0); i < nboxes; ++i) {
+            const int whichFile(br.get<int>());
+            if(whichFile < 0 || whichFile >= nfiles) {
+                return false;
+            }
+            hd.m_fod[i].m_name = fileNames[whichFile];
+            hd.m_fod[i].m_head = br.get<Long>();
+        }
+
+        if(br.get<int>()) {   // ---- min and max of each fab
+            hd.m_min.resize(nboxes);
+            hd.m_max.resize(nboxes);
+            for(Long i(0); i < nboxes; ++i) {
+                hd.m_min[i].resize(hd.m_ncomp);
+                hd.m_max[i].resize(hd.m_ncomp);
+                for(int n(0); n < hd.m_ncomp; ++n) {
+                    hd.m_min[i][n] = br.get<Real>();
+                    hd.m_max[i][n] = br.get<Real>();
+                }
+            }
+        }
+        if(br.get<int>()) {   // ---- min and max of the FabArray
+            hd.m_famin.resize(hd.m_ncomp);
+            hd.m_famax.resize(hd.m_ncomp);
+            for(int n(0); n < hd.m_ncomp; ++n) {
+                hd.m_famin[n] = br.get<Real>();
+                hd.m_famax[n] = br.get<Real>();
+            }
+        }
+
+        const std::string rd(br.getString());
+        if( ! rd.empty()) {
+            std::istringstream is(rd);
+            is >> hd.m_writtenRD;
+        }
+        hd.m_codec = static_cast<FabCodec::Type>(br.get<int>());
+        if(br.get<int>()) {   // ---- compressed size of each fab
+            hd.m_fab_nbytes.resize(nboxes);
+            for(Long i(0); i < nboxes; ++i) {
+                hd.m_fab_nbytes[i] = br.get<Long>();
+            }
+        }
+        return br.m_ok;
+    }
 }
 
 void
@@ -87,6 +291,15 @@ VisMF::Initialize ()
     pp.query("usedynamicsetselection", useDynamicSetSelection);
     pp.query("iobuffersize", ioBufferSize);
     pp.query("allowsparsewrites", allowSparseWrites);
+    pp.query("binary_index", binaryIndex);
+
+    std::string codec(FabCodec::Name(compression));
+    pp.query("compression", codec);
+    compression = FabCodec::FromName(codec);
+    pp.query("plotfile_compression", codec);
+    plotfileCompression = FabCodec::FromName(codec);
+    pp.queryarr("lossy_abs_tol", lossyAbsTol);
+    pp.queryarr("lossy_rel_tol", lossyRelTol);
 
     initialized = true;
 }
@@ -291,7 +504,9 @@ operator<< (std::ostream        &os,
       os << hd.m_max      << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::NoFabHeaderCompressed_v1)
+    {
       BL_ASSERT(hd.m_famin.size() == hd.m_ncomp);
       BL_ASSERT(hd.m_famin.size() == hd.m_famax.size());
       for(int i(0); i < hd.m_famin.size(); ++i) {
@@ -317,6 +532,17 @@ operator<< (std::ostream        &os,
       }
     }
 
+    if(hd.m_vers == VisMF::Header::NoFabHeaderCompressed_v1) {
+      // ---- compressed data are always native
+      os << FPC::NativeRealDescriptor() << '\n';
+      os << FabCodec::Name(hd.m_codec) << '\n';
+      os << hd.m_fab_nbytes.size() << '\n';
+      for(int i(0); i < hd.m_fab_nbytes.size(); ++i) {
+        os << hd.m_fab_nbytes[i] << ' ';
+      }
+      os << '\n';
+    }
+
     os.flags(oflags);
     os.precision(oldPrec);
 
@@ -377,7 +603,9 @@ operator>> (std::istream  &is,
       BL_ASSERT(hd.m_ba.size() == hd.m_max.size());
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::NoFabHeaderCompressed_v1)
+    {
       char ch;
       hd.m_famin.resize(hd.m_ncomp);
       hd.m_famax.resize(hd.m_ncomp);
@@ -400,7 +628,19 @@ operator>> (std::istream  &is,
     {
       is >> hd.m_writtenRD;
     }
-
+    if(hd.m_vers == VisMF::Header::NoFabHeaderCompressed_v1) {
+      is >> hd.m_writtenRD;
+      std::string codec;
+      is >> codec;
+      hd.m_codec = FabCodec::FromName(codec);
+      int nfabs;
+      is >> nfabs;
+      BL_ASSERT(nfabs == hd.m_ba.size());
+      hd.m_fab_nbytes.resize(nfabs);
+      for(int i(0); i < nfabs; ++i) {
+        is >> hd.m_fab_nbytes[i];
+      }
+    }
 
     if( ! is.good()) {
         amrex::Error("Read of VisMF::Header failed");
@@ -524,6 +764,196 @@ VisMF::GetFab (int fabIndex,
     return *m_pa[ncomp][fabIndex];
 }
 
+#ifndef _WIN32
+struct VisMF::MappedFile
+{
+    explicit MappedFile (const std::string& name)
+    {
+        int fd = ::open(name.c_str(), O_RDONLY);
+        if(fd < 0) {
+            amrex::FileOpenFailed(name);
+        }
+        struct stat st;
+        if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(p == MAP_FAILED) {
+                ::close(fd);
+                amrex::Error("VisMF: failed to map " + name);
+            }
+            m_data = static_cast<const char *>(p);
+            m_size = st.st_size;
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile ()
+    {
+        if(m_data != nullptr) {
+            ::munmap(const_cast<char *>(m_data), m_size);
+        }
+    }
+
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+
+    const char *m_data = nullptr;
+    Long        m_size = 0;
+};
+#endif
+
+void
+VisMF::ReleaseMappedFiles () const
+{
+#ifndef _WIN32
+#ifdef _OPENMP
+#pragma omp critical (vismf_mapped_files)
+#endif
+    m_mapped_files.clear();
+#endif
+}
+
+void
+VisMF::ReadRegions (FabArray<FArrayBox> &mf,
+                    const std::string &mf_name,
+                    VisMF::Header &&hdr_in)
+{
+    BL_PROFILE("VisMF::ReadRegions()");
+
+    if(hdr_in.m_ncomp != mf.nComp()) {
+        amrex::Error("VisMF::Read: " + mf_name + " has a different number of components");
+    }
+
+    VisMF vismf(mf_name, std::move(hdr_in));
+    const VisMF::Header &hdr = vismf.m_hdr;
+    BoxArray grown_ba(hdr.m_ba);
+    grown_ba.grow(hdr.m_ngrow);
+    const bool has_ghost(hdr.m_ngrow.max() > 0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for(MFIter mfi(mf, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi) {
+        FArrayBox &fab = mf[mfi];
+        // ---- ghost cells first, so that valid cells on disk take precedence
+        if(has_ghost) {
+            for(const auto &is : grown_ba.intersections(fab.box())) {
+                for(int n(0); n < hdr.m_ncomp; ++n) {
+                    vismf.ReadFabRegion(is.first, n, is.second, fab, n);
+                }
+            }
+        }
+        for(const auto &is : hdr.m_ba.intersections(fab.box())) {
+            for(int n(0); n < hdr.m_ncomp; ++n) {
+                vismf.ReadFabRegion(is.first, n, is.second, fab, n);
+            }
+        }
+    }
+    vismf.ReleaseMappedFiles();
+}
+
+void
+VisMF::ReadFabRegion (int fabIndex, int comp, const Box& region,
+                      FArrayBox& dst, int dcomp) const
+{
+    BL_ASSERT(0 <= fabIndex && fabIndex < m_hdr.m_ba.size());
+    BL_ASSERT(0 <= comp && comp < m_hdr.m_ncomp);
+
+    Box fab_box(amrex::grow(m_hdr.m_ba[fabIndex], m_hdr.m_ngrow));
+    AMREX_ALWAYS_ASSERT(fab_box.contains(region) && dst.box().contains(region));
+    if(region.isEmpty()) {
+        return;
+    }
+
+#ifdef _WIN32
+    // ---- no memory mapping, read the whole component with the stream reader
+    std::unique_ptr<FArrayBox> tmp;
+#ifdef _OPENMP
+#pragma omp critical (vismf_read_fab_region)
+#endif
+    {
+        tmp.reset(VisMF::readFAB(fabIndex, m_fafabname, m_hdr, comp));
+        VisMF::CloseStream(VisMF::DirName(m_fafabname) + m_hdr.m_fod[fabIndex].m_name, true);
+    }
+    dst.copy<RunOn::Host>(*tmp, region, 0, region, dcomp, 1);
+#else
+    const std::string fileName(VisMF::DirName(m_fafabname) + m_hdr.m_fod[fabIndex].m_name);
+    std::shared_ptr<MappedFile> mfile;
+#ifdef _OPENMP
+#pragma omp critical (vismf_mapped_files)
+#endif
+    {
+        auto it = m_mapped_files.find(fileName);
+        if(it == m_mapped_files.end()) {
+            // ---- bound the number of open mappings; readers still
+            // ---- using a dropped file hold their own reference
+            if(static_cast<int>(m_mapped_files.size()) >= max_mapped_files) {
+                m_mapped_files.clear();
+            }
+            it = m_mapped_files.emplace(fileName, std::make_shared<MappedFile>(fileName)).first;
+        }
+        mfile = it->second;
+    }
+    const char *fabData = mfile->m_data + m_hdr.m_fod[fabIndex].m_head;
+    const char *fileEnd = mfile->m_data + mfile->m_size;
+
+    if(m_hdr.m_vers == VisMF::Header::NoFabHeaderCompressed_v1) {
+        // ---- a component has to be decompressed as a whole
+        FArrayBox tmp(fab_box, 1);
+        if(fabData + m_hdr.m_fab_nbytes[fabIndex] > fileEnd) {
+            amrex::Error("VisMF::ReadFabRegion: " + fileName + " is too short");
+        }
+        decompressFAB(fabData, m_hdr.m_fab_nbytes[fabIndex], m_hdr.m_ncomp, tmp, comp);
+        dst.copy<RunOn::Host>(tmp, region, 0, region, dcomp, 1);
+        return;
+    }
+
+    RealDescriptor rd(m_hdr.m_writtenRD);
+    if(m_hdr.m_vers == VisMF::Header::Version_v1) {
+        // ---- skip the fab header, which also has the format of the data
+        const char *eol = static_cast<const char *>(std::memchr(fabData, '\n', fileEnd - fabData));
+        if(eol == nullptr || std::strncmp(fabData, "FAB ", 4) != 0) {
+            amrex::Error("VisMF::ReadFabRegion: unsupported FAB header in " + fileName);
+        }
+        std::istringstream is(std::string(fabData + 4, eol));
+        int ncomp;
+        is >> rd >> fab_box >> ncomp;
+        if(is.fail()) {
+            amrex::Error("VisMF::ReadFabRegion: bad FAB header in " + fileName);
+        }
+        fabData = eol + 1;
+    }
+
+    const bool doConvert(rd != FPC::NativeRealDescriptor());
+    const Long nBytes(rd.numBytes());
+    const Long npts(fab_box.numPts());
+    const auto flo = amrex::lbound(fab_box);
+    const auto fhi = amrex::ubound(fab_box);
+    const Long nx(fhi.x - flo.x + 1);
+    const Long ny(fhi.y - flo.y + 1);
+    if(fabData + (comp+1)*npts*nBytes > fileEnd) {
+        amrex::Error("VisMF::ReadFabRegion: " + fileName + " is too short");
+    }
+
+    const auto lo  = amrex::lbound(region);
+    const auto hi  = amrex::ubound(region);
+    const Long rowLength(hi.x - lo.x + 1);
+    const auto d = dst.array();
+    for(int k(lo.z); k <= hi.z; ++k) {
+        for(int j(lo.y); j <= hi.y; ++j) {
+            const Long offset(comp*npts + (lo.x - flo.x)
+                              + nx * ((j - flo.y) + ny * (k - flo.z)));
+            const char *src = fabData + offset * nBytes;
+            Real *out = &d(lo.x, j, k, dcomp);
+            if(doConvert) {
+                RealDescriptor::convertToNativeFormat(out, rowLength, const_cast<char *>(src), rd);
+            } else {
+                std::memcpy(out, src, rowLength * sizeof(Real));
+            }
+        }
+    }
+#endif
+}
+
 void
 VisMF::clear (int fabIndex,
               int compIndex)
@@ -673,7 +1103,11 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
              mf.arena() == The_Device_Arena() or
              mf.arena() == The_Managed_Arena());
 
-    if(version == NoFabHeaderFAMinMax_v1) {
+    if(version == NoFabHeaderCompressed_v1) {
+      m_fab_nbytes.resize(m_ba.size(), 0);
+    }
+
+    if(version == NoFabHeaderFAMinMax_v1 || version == NoFabHeaderCompressed_v1) {
       // ---- calculate FabArray min max values only
       m_min.clear();
       m_max.clear();
@@ -910,9 +1344,174 @@ VisMF::WriteHeaderDoit (const std::string&mf_name, const VisMF::Header& hdr)
     MFHdrFile.flush();
     MFHdrFile.close();
 
+    VisMF::WriteBinaryIndex(mf_name, hdr, bytesWritten);
+
     return bytesWritten;
 }
 
+void
+VisMF::WriteBinaryIndex (const std::string &mf_name, const VisMF::Header &hdr,
+                         Long hdrBytes)
+{
+    std::string IndexFileName(mf_name + TheMultiFabBinaryIndexSuffix);
+
+    if( ! binaryIndex) {
+        // ---- an index from an earlier write would not match the header
+        std::remove(IndexFileName.c_str());
+        return;
+    }
+
+    VisMF::IO_Buffer io_buffer(ioBufferSize);
+
+    std::ofstream IndexFile;
+
+    IndexFile.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+
+    IndexFile.open(IndexFileName.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+
+    if( ! IndexFile.good()) {
+        amrex::FileOpenFailed(IndexFileName);
+    }
+
+    IndexFile.write(binaryIndexMagic, sizeof(binaryIndexMagic));
+    putBinary(IndexFile, binaryIndexFormat);
+    putBinary(IndexFile, int(sizeof(int)));
+    putBinary(IndexFile, int(sizeof(Long)));
+    putBinary(IndexFile, int(sizeof(Real)));
+    putBinary(IndexFile, int(AMREX_SPACEDIM));
+    putBinary(IndexFile, hdrBytes);
+
+    putBinary(IndexFile, hdr.m_vers);
+    putBinary(IndexFile, int(hdr.m_how));
+    putBinary(IndexFile, hdr.m_ncomp);
+    const IntVect typ(hdr.m_ba.ixType().ixType());
+    for(int idim(0); idim < AMREX_SPACEDIM; ++idim) {
+        putBinary(IndexFile, hdr.m_ngrow[idim]);
+        putBinary(IndexFile, typ[idim]);
+    }
+
+    const Long nboxes(hdr.m_ba.size());
+    putBinary(IndexFile, nboxes);
+    for(Long i(0); i < nboxes; ++i) {
+        const Box &bx = hdr.m_ba[i];
+        for(int idim(0); idim < AMREX_SPACEDIM; ++idim) {
+            putBinary(IndexFile, bx.smallEnd(idim));
+            putBinary(IndexFile, bx.bigEnd(idim));
+        }
+    }
+
+    // ---- the fabs share a few files, so the names are written once
+    std::map<std::string, int> fileIndex;
+    Vector<std::string> fileNames;
+    Vector<int> whichFile(nboxes);
+    for(Long i(0); i < nboxes; ++i) {
+        auto r = fileIndex.insert(std::make_pair(hdr.m_fod[i].m_name, int(fileNames.size())));
+        if(r.second) {
+            fileNames.push_back(hdr.m_fod[i].m_name);
+        }
+        whichFile[i] = r.first->second;
+    }
+    putBinary(IndexFile, int(fileNames.size()));
+    for(const auto &name : fileNames) {
+        putBinary(IndexFile, name);
+    }
+    for(Long i(0); i < nboxes; ++i) {
+        putBinary(IndexFile, whichFile[i]);
+        putBinary(IndexFile, hdr.m_fod[i].m_head);
+    }
+
+    const bool fabMinMax(hdr.m_vers == VisMF::Header::Version_v1 ||
+                         hdr.m_vers == VisMF::Header::NoFabHeaderMinMax_v1);
+    putBinary(IndexFile, int(fabMinMax));
+    if(fabMinMax) {
+        for(Long i(0); i < nboxes; ++i) {
+            for(int n(0); n < hdr.m_ncomp; ++n) {
+                putBinary(IndexFile, hdr.m_min[i][n]);
+                putBinary(IndexFile, hdr.m_max[i][n]);
+            }
+        }
+    }
+    const bool faMinMax(hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+                        hdr.m_vers == VisMF::Header::NoFabHeaderCompressed_v1);
+    putBinary(IndexFile, int(faMinMax));
+    if(faMinMax) {
+        for(int n(0); n < hdr.m_ncomp; ++n) {
+            putBinary(IndexFile, hdr.m_famin[n]);
+            putBinary(IndexFile, hdr.m_famax[n]);
+        }
+    }
+
+    // ---- the same descriptor as in the ASCII header
+    std::ostringstream rd;
+    if(hdr.m_vers == VisMF::Header::NoFabHeaderCompressed_v1) {
+        rd << FPC::NativeRealDescriptor();
+    } else if(NoFabHeader(hdr)) {
+        if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
+            rd << FPC::NativeRealDescriptor();
+        } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
+            rd << FPC::Native32RealDescriptor();
+        } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
+            rd << FPC::Ieee32NormalRealDescriptor();
+        }
+    }
+    putBinary(IndexFile, rd.str());
+
+    putBinary(IndexFile, int(hdr.m_codec));
+    const bool fabBytes(hdr.m_vers == VisMF::Header::NoFabHeaderCompressed_v1);
+    putBinary(IndexFile, int(fabBytes));
+    if(fabBytes) {
+        for(Long i(0); i < nboxes; ++i) {
+            putBinary(IndexFile, hdr.m_fab_nbytes[i]);
+        }
+    }
+
+    IndexFile.flush();
+    if( ! IndexFile.good()) {
+        amrex::Error("Write of VisMF binary index failed");
+    }
+    IndexFile.close();
+}
+
+void
+VisMF::ReadHeaderFile (const std::string &mf_name, VisMF::Header &hdr)
+{
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(mf_name + TheMultiFabBinaryIndexSuffix,
+                                         fileCharPtr, false);
+    if( ! fileCharPtr.empty()) {
+        // ---- The index is only used if the ASCII header has the size
+        // ---- it was written with, so that an index left behind does
+        // ---- not shadow a header written later by other means.
+        Long hdrBytes(-1);
+        if(ParallelDescriptor::IOProcessor()) {
+            std::ifstream hdrFile((mf_name + TheMultiFabHdrFileSuffix).c_str(),
+                                  std::ios::in | std::ios::binary | std::ios::ate);
+            if(hdrFile.good()) {
+                hdrBytes = hdrFile.tellg();
+            }
+        }
+        ParallelDescriptor::Bcast(&hdrBytes, 1, ParallelDescriptor::IOProcessorNumber());
+
+        VisMF::Header binHdr;
+        // ---- ReadAndBcastFile appends a '\0'
+        if(readBinaryIndex(fileCharPtr.dataPtr(), fileCharPtr.size() - 1, hdrBytes, binHdr)) {
+            hdr = std::move(binHdr);
+            return;
+        }
+        if(verbose && ParallelDescriptor::IOProcessor()) {
+            amrex::Print() << "VisMF::ReadHeaderFile:  ignoring the binary index of "
+                           << mf_name << std::endl;
+        }
+        fileCharPtr.clear();
+    }
+
+    ParallelDescriptor::ReadAndBcastFile(mf_name + TheMultiFabHdrFileSuffix, fileCharPtr);
+    std::string fileCharPtrString(fileCharPtr.dataPtr());
+    std::istringstream infs(fileCharPtrString, std::istringstream::in);
+
+    infs >> hdr;
+}
+
 Long
 VisMF::WriteHeader (const std::string &mf_name, VisMF::Header &hdr,
 		    int procToWrite, MPI_Comm comm)
@@ -1011,13 +1610,17 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     int coordinatorProc(ParallelDescriptor::IOProcessorNumber());
     Long bytesWritten(0);
     bool calcMinMax(false);
-    VisMF::Header hdr(mf, how, currentVersion, calcMinMax);
+    const bool compressed(compression != FabCodec::None);
+    const VisMF::Header::Version whichVersion(compressed ? VisMF::Header::NoFabHeaderCompressed_v1
+                                                         : currentVersion);
+    VisMF::Header hdr(mf, how, whichVersion, calcMinMax);
+    hdr.m_codec = compression;
 
     std::string filePrefix(mf_name + FabFileSuffix);
 
     NFilesIter nfi(nOutFiles, filePrefix, groupSets, setBuf);
 
-    bool oldHeader(currentVersion == VisMF::Header::Version_v1);
+    bool oldHeader(whichVersion == VisMF::Header::Version_v1);
 
     if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
@@ -1025,6 +1628,10 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         nfi.SetDynamic();
     }
     for( ; nfi.ReadyToWrite(); ++nfi) {
+        if(compressed) {
+            bytesWritten += VisMF::WriteCompressed(mf, nfi.Stream(), hdr);
+            continue;
+        }
         // ---- find the total number of bytes including fab headers if needed
         const FABio &fio = FArrayBox::getFABio();
         int whichRDBytes(whichRD->numBytes()), nFABs(0);
@@ -1112,17 +1719,22 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         coordinatorProc = nfi.CoordinatorProc();
     }
 
+    if(compressed) {    // ---- the coordinator needs the sizes for the offsets
+        ParallelDescriptor::ReduceLongSum(hdr.m_fab_nbytes.dataPtr(), hdr.m_fab_nbytes.size(),
+                                          coordinatorProc);
+    }
+
     if (Gpu::inLaunchRegion()) {
         amrex::prefetchToDevice(mf);  // CalculateMinMax might do work on device
     }
 
-    if(currentVersion == VisMF::Header::Version_v1 ||
-       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(whichVersion == VisMF::Header::Version_v1 ||
+       whichVersion == VisMF::Header::NoFabHeaderMinMax_v1)
     {
         hdr.CalculateMinMax(mf, coordinatorProc);
     }
 
-    VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
+    VisMF::FindOffsets(mf, filePrefix, hdr, whichVersion, nfi,
                        ParallelDescriptor::Communicator());
 
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
@@ -1133,6 +1745,72 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 }
 
 
+Long
+VisMF::WriteCompressed (const FabArray<FArrayBox> &mf,
+                        std::ostream &os,
+                        VisMF::Header &hdr)
+{
+    BL_PROFILE("VisMF::WriteCompressed");
+
+    // ---- With a 32-bit fab.format, the values are rounded to single
+    // ---- precision before they are compressed, and stored as native Reals.
+    const bool round32(sizeof(Real) > sizeof(float) &&
+                       (FArrayBox::getFormat() == FABio::FAB_NATIVE_32 ||
+                        FArrayBox::getFormat() == FABio::FAB_IEEE_32));
+
+    // ---- each component is stored as its size followed by the compressed data
+    Long bytesWritten(0);
+    Vector<char> buffer;
+    Vector<Real> rounded;
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const FArrayBox &fab = mf[mfi];
+        const Long npts(fab.box().numPts());
+        buffer.clear();
+        for(int n(0); n < mf.nComp(); ++n) {
+            const Real *src = fab.dataPtr(n);
+            if(round32) {
+                rounded.resize(npts);
+                for(Long i(0); i < npts; ++i) {
+                    rounded[i] = static_cast<float>(src[i]);
+                }
+                src = rounded.dataPtr();
+            }
+            const Long start(buffer.size());
+            buffer.resize(start + sizeof(Long));
+            FabCodec::Compress(compression, src, npts, LossyTolerance(fab, n), buffer);
+            const Long nbytes(buffer.size() - start - sizeof(Long));
+            std::memcpy(buffer.dataPtr() + start, &nbytes, sizeof(Long));
+        }
+        os.write(buffer.dataPtr(), buffer.size());
+        os.flush();
+        hdr.m_fab_nbytes[mfi.index()] = buffer.size();
+        bytesWritten += buffer.size();
+    }
+    return bytesWritten;
+}
+
+Real
+VisMF::LossyTolerance (const FArrayBox &fab, int comp)
+{
+    if(compression != FabCodec::Lossy) {
+        return 0.0;
+    }
+    Real absTol(0.0), relTol(0.0);
+    if( ! lossyAbsTol.empty()) {
+        absTol = lossyAbsTol[std::min(comp, static_cast<int>(lossyAbsTol.size())-1)];
+    }
+    if( ! lossyRelTol.empty()) {
+        relTol = lossyRelTol[std::min(comp, static_cast<int>(lossyRelTol.size())-1)];
+    }
+    if(relTol > 0.0) {
+        relTol *= fab.max<RunOn::Host>(comp) - fab.min<RunOn::Host>(comp);
+    }
+    if(absTol > 0.0 && relTol > 0.0) {
+        return std::min(absTol, relTol);
+    }
+    return std::max(absTol, relTol);
+}
+
 Long
 VisMF::WriteOnlyHeader (const FabArray<FArrayBox> & mf,
                         const std::string         & mf_name,
@@ -1321,8 +1999,12 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 	      for(int i(0); i < index.size(); ++i) {
                  hdr.m_fod[index[i]].m_name = whichFileName;
                  hdr.m_fod[index[i]].m_head = currentOffset[whichFileNumber];
-                 currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
-	                                           + fabHeaderBytes[index[i]];
+                 if(hdr.m_vers == VisMF::Header::NoFabHeaderCompressed_v1) {
+                   currentOffset[whichFileNumber] += hdr.m_fab_nbytes[index[i]];
+                 } else {
+                   currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
+                                                     + fabHeaderBytes[index[i]];
+                 }
               }
             }
 	  }
@@ -1348,6 +2030,12 @@ VisMF::RemoveFiles(const std::string &mf_name, bool a_verbose)
 	            << strerror(errno) << std::endl;
         }
       }
+      // ---- the binary index may not exist
+      std::string IndexFileName(mf_name + TheMultiFabBinaryIndexSuffix);
+      if(a_verbose) {
+        amrex::Print() << "---- removing:  " << IndexFileName << std::endl;
+      }
+      std::remove(IndexFileName.c_str());
       for(int ip(0); ip < nOutFiles; ++ip) {
         std::string fileName(NFilesIter::FileName(nOutFiles, mf_name + FabFileSuffix, ip, true));
         if(a_verbose) {
@@ -1369,16 +2057,7 @@ VisMF::VisMF (const std::string &fafab_name)
     :
     m_fafabname(fafab_name)
 {
-    std::string FullHdrFileName(m_fafabname);
-
-    FullHdrFileName += TheMultiFabHdrFileSuffix;
-
-    Vector<char> fileCharPtr;
-    ParallelDescriptor::ReadAndBcastFile(FullHdrFileName, fileCharPtr);
-    std::string fileCharPtrString(fileCharPtr.dataPtr());
-    std::istringstream infs(fileCharPtrString, std::istringstream::in);
-
-    infs >> m_hdr;
+    VisMF::ReadHeaderFile(m_fafabname, m_hdr);
 
     m_pa.resize(m_hdr.m_ncomp);
 
@@ -1392,6 +2071,20 @@ VisMF::VisMF (const std::string &fafab_name)
 }
 
 
+VisMF::VisMF (const std::string &fafab_name,
+              Header &&hdr)
+    :
+    m_fafabname(fafab_name),
+    m_hdr(std::move(hdr))
+{
+    m_pa.resize(m_hdr.m_ncomp);
+
+    for(int n(0); n < m_pa.size(); ++n) {
+        m_pa[n].resize(m_hdr.m_ba.size(), nullptr);
+    }
+}
+
+
 VisMF::~VisMF ()
 {
 }
@@ -1417,7 +2110,9 @@ VisMF::readFAB (int                  idx,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(hdr.m_vers == Header::Version_v1) {
+    if(hdr.m_vers == Header::NoFabHeaderCompressed_v1) {
+      readCompressedFAB(*infs, hdr.m_fab_nbytes[idx], hdr.m_ncomp, *fab, whichComp);
+    } else if(hdr.m_vers == Header::Version_v1) {
       if(whichComp == -1) {    // ---- read all components
         fab->readFrom(*infs);
       } else {
@@ -1467,7 +2162,9 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(hdr.m_vers == VisMF::Header::NoFabHeaderCompressed_v1) {
+      readCompressedFAB(*infs, hdr.m_fab_nbytes[idx], hdr.m_ncomp, fab, -1);
+    } else if(NoFabHeader(hdr)) {
       if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
         infs->read((char *) fab.dataPtr(), fab.nBytes());
       } else {
@@ -1507,17 +2204,14 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 
     {
         hStartTime = amrex::second();
-        std::string fileCharPtrString;
 	if(faHeader == nullptr) {
-          Vector<char> fileCharPtr;
-          ParallelDescriptor::ReadAndBcastFile(FullHdrFileName, fileCharPtr);
-          fileCharPtrString = fileCharPtr.dataPtr();
+          VisMF::ReadHeaderFile(mf_name, hdr);
 	} else {
-          fileCharPtrString = faHeader;
-	}
-        std::istringstream infs(fileCharPtrString, std::istringstream::in);
+          std::string fileCharPtrString(faHeader);
+          std::istringstream infs(fileCharPtrString, std::istringstream::in);
 
-        infs >> hdr;
+          infs >> hdr;
+	}
 
         hEndTime = amrex::second();
     }
@@ -1538,20 +2232,23 @@ VisMF::Read (FabArray<FArrayBox> &mf,
     if (mf.empty()) {
 	DistributionMapping dm(hdr.m_ba);
 	mf.define(hdr.m_ba, dm, hdr.m_ncomp, hdr.m_ngrow, MFInfo(), FArrayBoxFactory());
-    } else {
-	BL_ASSERT(amrex::match(hdr.m_ba,mf.boxArray()));
+    } else if( ! amrex::match(hdr.m_ba,mf.boxArray()) || mf.nGrowVect() != hdr.m_ngrow) {
+        // ---- The FABs on disk do not have the shape of the FABs in mf.
+        VisMF::ReadRegions(mf, mf_name, std::move(hdr));
+        return;
     }
 
 #ifdef BL_USE_MPI
 
   // ---- This limits the number of concurrent readers per file.
   int nOpensPerFile(nMFFileInStreams);
-  int nProcs(ParallelDescriptor::NProcs());
   bool noFabHeader(NoFabHeader(hdr));
 
   if(noFabHeader && useSynchronousReads) {
 
-    // ---- This code is only for reading in file order
+    // ---- Each rank reads the FABs it owns in mf in file order, so
+    // ---- no copy is needed afterwards, whatever the number of ranks
+    // ---- that wrote the data.
     bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
 
     // ---- Create an ordered map of which processors read which
@@ -1560,73 +2257,24 @@ VisMF::Read (FabArray<FArrayBox> &mf,
     std::map<std::string, Vector<FabReadLink> > FileReadChains;        // ---- [filename, chain]
     std::map<std::string, std::set<int> > readFileRanks;              // ---- [filename, ranks]
 
+    const DistributionMapping &dm = mf.DistributionMap();
     int nBoxes(hdr.m_ba.size());
     for(int i(0); i < nBoxes; ++i) {   // ---- create the map
-      int undefined(-1);
       std::string fname(hdr.m_fod[i].m_name);
-      FileReadChains[fname].push_back(FabReadLink(undefined, undefined, hdr.m_fod[i].m_head, hdr.m_ba[i]));
+      FileReadChains[fname].push_back(FabReadLink(dm[i], i, hdr.m_fod[i].m_head, hdr.m_ba[i]));
+      readFileRanks[fname].insert(dm[i]);
     }
 
     std::map<std::string, Vector<FabReadLink> >::iterator frcIter;
 
-    int indexFileOrder(0);
-    int currentRank(0);
-    FabArray<FArrayBox> fafabFileOrder;
-    BoxArray baFileOrder(hdr.m_ba.size());
-
-    Vector<int> ranksFileOrder(mf.DistributionMap().size(), -1);
-
-    Vector<int> nRanksPerFile(FileReadChains.size());
-    amrex::NItemsPerBin(nProcs, nRanksPerFile);
-    int currentFileIndex(0);
-
     for(frcIter = FileReadChains.begin(); frcIter != FileReadChains.end(); ++frcIter) {
-      const std::string &fileName = frcIter->first;
       Vector<FabReadLink> &frc = frcIter->second;
       // ---- sort by offset
       std::sort(frc.begin(), frc.end(), [] (const FabReadLink &a, const FabReadLink &b)
 	                                      { return a.fileOffset < b.fileOffset; } );
-
-      Vector<int> nBoxesPerRank(nRanksPerFile[currentFileIndex]);
-      amrex::NItemsPerBin(frc.size(), nBoxesPerRank);
-      int frcIndex(0);
-
-      for(int nbpr(0); nbpr < nBoxesPerRank.size(); ++nbpr) {
-        for(int nb(0); nb < nBoxesPerRank[nbpr]; ++nb) {
-
-	  baFileOrder.set(indexFileOrder, frc[frcIndex].box);
-	  ranksFileOrder[indexFileOrder] = currentRank;
-	  frc[frcIndex].rankToRead = currentRank;
-	  frc[frcIndex].faIndex    = indexFileOrder;
-	  readFileRanks[fileName].insert(currentRank);
-
-	  ++frcIndex;
-	  ++indexFileOrder;
-        }
-        ++currentRank;
-        currentRank = std::min(currentRank, nProcs - 1);
-      }
-      ++currentFileIndex;
     }
 
-    DistributionMapping dmFileOrder(std::move(ranksFileOrder));
-
-    bool inFileOrder(mf.DistributionMap() == dmFileOrder && mf.boxArray() == baFileOrder);
-    if(inFileOrder) {
-      if(myProc == coordinatorProc && verbose) {
-          amrex::AllPrint() << "VisMF::Read:  inFileOrder" << std::endl;
-      }
-    } else {
-      if(myProc == coordinatorProc && verbose) {
-          amrex::AllPrint() << "VisMF::Read:  not inFileOrder" << std::endl;
-      }
-      // ---- make a temporary fabarray in file order
-      fafabFileOrder.define(baFileOrder, dmFileOrder, hdr.m_ncomp, hdr.m_ngrow, MFInfo(), mf.Factory());
-    }
-
-    FabArray<FArrayBox> &whichFA = inFileOrder ? mf : fafabFileOrder;
-
-    // ---- check that a rank only needs to read one file
+    // ---- limit the number of ranks reading a file at the same time
     std::map<std::string, std::set<int> >::iterator rfrIter;
     std::set<int>::iterator setIter;
 
@@ -1665,81 +2313,64 @@ VisMF::Read (FabArray<FArrayBox> &mf,
           Vector<FabReadLink> &frc = frcIter->second;
           for(NFilesIter nfi(fullFileName, readRanks); nfi.ReadyToRead(); ++nfi) {
 
-	      // ---- confirm the data is contiguous in the stream
-	      Long firstOffset(-1);
-	      for(int i(0); i < frc.size(); ++i) {
-	        if(myProc == frc[i].rankToRead) {
-		  firstOffset = frc[i].fileOffset;
-		  break;
-		}
+	    // ---- runs of my FABs that are contiguous in the file can be
+	    // ---- read at once
+	    int iRun(0);
+	    while(iRun < frc.size()) {
+	      if(myProc != frc[iRun].rankToRead) {
+	        ++iRun;
+	        continue;
 	      }
-
-	      bool dataIsContiguous(true);
-	      Long currentOffset(firstOffset), bytesToRead(0);
-	      int nFABs(0);
-
-	      for(int i(0); i < frc.size(); ++i) {
-	        if(myProc == frc[i].rankToRead) {
-	          if(currentOffset != frc[i].fileOffset) {
-                    dataIsContiguous = false;
-	          } else {
-	            FArrayBox &fab = whichFA[frc[i].faIndex];
-		    Long fabBytesToRead(fab.box().numPts() * fab.nComp() * hdr.m_writtenRD.numBytes());
-                    currentOffset += fabBytesToRead;
-                    bytesToRead   += fabBytesToRead;
-		    ++nFABs;
-		  }
-	        }
+	      int iEnd(iRun);
+	      Long bytesToRead(0);
+	      while(iEnd < frc.size() && myProc == frc[iEnd].rankToRead &&
+	            frc[iEnd].fileOffset == frc[iRun].fileOffset + bytesToRead)
+	      {
+	        FArrayBox &fab = mf[frc[iEnd].faIndex];
+	        bytesToRead += fab.box().numPts() * fab.nComp() * hdr.m_writtenRD.numBytes();
+	        ++iEnd;
 	      }
-	      char *allFabData;
-	      bool canCombineFABs(false);
-	      if(nFABs > 1 && dataIsContiguous && VisMF::useSingleRead) {
+
+	      char *allFabData(nullptr);
+	      if(iEnd - iRun > 1 && VisMF::useSingleRead) {
 	        allFabData = new(std::nothrow) char[bytesToRead];
-		if(allFabData == nullptr) {
-		  canCombineFABs = false;
-		} else {
-		  canCombineFABs = true;
-		}
 	      }
-	      if(canCombineFABs) {
-                nfi.Stream().seekp(firstOffset, std::ios::beg);
+	      if(static_cast<std::streamoff>(nfi.SeekPos()) != frc[iRun].fileOffset) {
+                nfi.Stream().seekp(frc[iRun].fileOffset, std::ios::beg);
+	      }
+
+	      if(allFabData != nullptr) {
                 nfi.Stream().read(allFabData, bytesToRead);
 
-		currentOffset = 0;  // ---- this is now relative to allFabData
-
-	        for(int i(0); i < frc.size(); ++i) {
-	          if(myProc == frc[i].rankToRead) {
-		    char *afPtr = allFabData + currentOffset;
-	            FArrayBox &fab = whichFA[frc[i].faIndex];
-		    Long readDataItems(fab.box().numPts() * fab.nComp());
-		    if(doConvert) {
-		      RealDescriptor::convertToNativeFormat(fab.dataPtr(), readDataItems,
-		                                            afPtr, hdr.m_writtenRD);
-		    } else {
-                      memcpy(fab.dataPtr(), afPtr, fab.nBytes());
-		    }
-                    currentOffset += readDataItems * hdr.m_writtenRD.numBytes();
-	          }
+		Long currentOffset(0);  // ---- this is relative to allFabData
+	        for(int i(iRun); i < iEnd; ++i) {
+		  char *afPtr = allFabData + currentOffset;
+	          FArrayBox &fab = mf[frc[i].faIndex];
+		  Long readDataItems(fab.box().numPts() * fab.nComp());
+		  if(doConvert) {
+		    RealDescriptor::convertToNativeFormat(fab.dataPtr(), readDataItems,
+		                                          afPtr, hdr.m_writtenRD);
+		  } else {
+                    memcpy(fab.dataPtr(), afPtr, fab.nBytes());
+		  }
+                  currentOffset += readDataItems * hdr.m_writtenRD.numBytes();
 	        }
 		delete [] allFabData;
 
-	      } else {          // ---- cannot use one read
-	        for(int i(0); i < frc.size(); ++i) {
-	          if(myProc == frc[i].rankToRead) {
-	            if(static_cast<std::streamoff>(nfi.SeekPos()) != frc[i].fileOffset) {
-                      nfi.Stream().seekp(frc[i].fileOffset, std::ios::beg);
-	            }
-	            FArrayBox &fab = whichFA[frc[i].faIndex];
-		    Long readDataItems(fab.box().numPts() * fab.nComp());
-		    if(doConvert) {
-		      RealDescriptor::convertToNativeFormat(fab.dataPtr(), readDataItems,
-		                                            nfi.Stream(), hdr.m_writtenRD);
-		    } else {
-                      nfi.Stream().read((char *) fab.dataPtr(), fab.nBytes());
-		    }
-	          }
+	      } else {          // ---- one read per fab
+	        for(int i(iRun); i < iEnd; ++i) {
+	          FArrayBox &fab = mf[frc[i].faIndex];
+		  Long readDataItems(fab.box().numPts() * fab.nComp());
+		  if(doConvert) {
+		    RealDescriptor::convertToNativeFormat(fab.dataPtr(), readDataItems,
+		                                          nfi.Stream(), hdr.m_writtenRD);
+		  } else {
+                    nfi.Stream().read((char *) fab.dataPtr(), fab.nBytes());
+		  }
 	        }
 	      }
+	      iRun = iEnd;
+	    }
 
           }    // ---- end NFilesIter
         }
@@ -1747,12 +2378,6 @@ VisMF::Read (FabArray<FArrayBox> &mf,
       }
     }
 
-    if( ! inFileOrder) {
-      faCopyTime = amrex::second();
-      mf.copy(fafabFileOrder);
-      faCopyTime = amrex::second() - faCopyTime;
-    }
-
   } else {    // ---- (noFabHeader && useSynchronousReads) == false
 
     int nReqs(0), ioProcNum(coordinatorProc);
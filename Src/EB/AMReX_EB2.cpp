@@ -11,7 +11,12 @@
 #include <AMReX_EB2.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX.H>
+#include <AMReX_Utility.H>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -20,11 +25,18 @@ Vector<std::unique_ptr<IndexSpace> > IndexSpace::m_instance;
 int max_grid_size = 64;
 bool extend_domain_face = true;
 
+namespace {
+    std::string cache_dir;
+    std::string cache_key;
+}
+
 void Initialize ()
 {
     ParmParse pp("eb2");
     pp.query("max_grid_size", max_grid_size);
     pp.query("extend_domain_face", extend_domain_face);
+    pp.query("cache_dir", cache_dir);
+    pp.query("cache_key", cache_key);
 
     amrex::ExecOnFinalize(Finalize);
 }
@@ -63,6 +75,104 @@ IndexSpace::erase (IndexSpace* ispace)
     }
 }
 
+std::string
+IndexSpaceCacheName (const Geometry& geom,
+                     int required_coarsening_level, int max_coarsening_level,
+                     int ngrow, bool build_coarse_level_by_coarsening,
+                     bool a_extend_domain_face,
+                     const std::string* impfunc_params)
+{
+    if (cache_dir.empty()) return std::string();
+
+    if (impfunc_params == nullptr && cache_key.empty()) {
+        amrex::Print() << "EB2: the implicit function cannot be identified, so the IndexSpace"
+                       << " is not cached.  Set eb2.cache_key to cache it.\n";
+        return std::string();
+    }
+
+    // GShopLevel reads these itself, so they are not among the arguments.
+    Real small_volfrac = 1.e-14;
+    bool balance_geometry = true;
+    int cost_sample_stride = 4;
+    {
+        ParmParse pp("eb2");
+        pp.query("small_volfrac", small_volfrac);
+        pp.query("balance_geometry", balance_geometry);
+        pp.query("cost_sample_stride", cost_sample_stride);
+    }
+
+    std::string name;
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ostringstream os;
+        os.precision(17);
+        os << cache_key << ' ' << geom.Domain() << ' ' << geom.Coord();
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            os << ' ' << geom.ProbLo(idim) << ' ' << geom.ProbHi(idim) << ' ' << geom.isPeriodic(idim);
+        }
+        os << ' ' << required_coarsening_level << ' ' << max_coarsening_level
+           << ' ' << ngrow << ' ' << build_coarse_level_by_coarsening
+           << ' ' << a_extend_domain_face << ' ' << max_grid_size << ' ' << sizeof(Real)
+           << ' ' << small_volfrac << ' ' << balance_geometry << ' ' << cost_sample_stride;
+        if (impfunc_params) {
+            os << ' ' << *impfunc_params;
+        }
+
+        // 64-bit FNV-1a
+        std::uint64_t h = 14695981039346656037ULL;
+        const std::string& params = os.str();
+        for (const char c : params) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ULL;
+        }
+
+        std::ostringstream nameos;
+        nameos << cache_dir << "/EB2_" << std::hex << std::setw(16) << std::setfill('0') << h;
+        name = nameos.str();
+    }
+
+    amrex::BroadcastString(name, ParallelDescriptor::MyProc(),
+                           ParallelDescriptor::IOProcessorNumber(),
+                           ParallelDescriptor::Communicator());
+    return name;
+}
+
+bool
+IndexSpaceCacheExists (const std::string& dirname)
+{
+    int exists = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        exists = amrex::FileExists(dirname+"/Header");
+    }
+    ParallelDescriptor::Bcast(&exists, 1, ParallelDescriptor::IOProcessorNumber());
+    if (exists && amrex::Verbose() > 0) {
+        amrex::Print() << "EB2: reading IndexSpace from " << dirname << "\n";
+    }
+    return exists;
+}
+
+void
+WriteIndexSpaceCache (const IndexSpace& ebis, const std::string& dirname)
+{
+    BL_PROFILE("EB2::WriteIndexSpaceCache()");
+
+    if (amrex::Verbose() > 0) {
+        amrex::Print() << "EB2: writing IndexSpace to " << dirname << "\n";
+    }
+
+    // Write to a temporary directory first, so that a run that is killed
+    // while writing does not leave an incomplete cache behind.
+    const std::string tmpname = dirname + ".temp";
+    amrex::UtilCreateCleanDirectory(tmpname, true);
+    ebis.write(tmpname);
+
+    ParallelDescriptor::Barrier("EB2::WriteIndexSpaceCache");
+    if (ParallelDescriptor::IOProcessor()) {
+        std::rename(tmpname.c_str(), dirname.c_str());
+    }
+    ParallelDescriptor::Barrier("EB2::WriteIndexSpaceCache::rename");
+}
+
 const IndexSpace* TopIndexSpaceIfPresent() noexcept {
     if (IndexSpace::size() > 0) {
         return &IndexSpace::top();
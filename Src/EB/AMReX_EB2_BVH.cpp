@@ -0,0 +1,92 @@
+
+#include <AMReX_EB2_BVH.H>
+#include <AMReX.H>
+
+#include <algorithm>
+
+namespace amrex { namespace EB2 {
+
+constexpr int BVH::max_depth;
+
+BVH::BVH (const Vector<RealArray>& a_lo, const Vector<RealArray>& a_hi, int a_leaf_size)
+{
+    define(a_lo, a_hi, a_leaf_size);
+}
+
+void
+BVH::define (const Vector<RealArray>& a_lo, const Vector<RealArray>& a_hi, int a_leaf_size)
+{
+    AMREX_ALWAYS_ASSERT(a_lo.size() == a_hi.size());
+
+    m_leaf_size = std::max(a_leaf_size, 1);
+    m_lo = a_lo;
+    m_hi = a_hi;
+
+    const int n = m_lo.size();
+    m_prim.resize(n);
+    for (int i = 0; i < n; ++i) {
+        m_prim[i] = i;
+    }
+
+    m_node.clear();
+    if (n > 0) {
+        m_node.reserve(2*(n/m_leaf_size+1));
+        build(0, n, 0);
+    }
+}
+
+int
+BVH::build (int begin, int end, int depth)
+{
+    AMREX_ALWAYS_ASSERT(depth < max_depth/2);
+
+    const int inode = m_node.size();
+    m_node.emplace_back();
+
+    RealArray lo, hi, clo, chi;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        lo[idim] = clo[idim] = std::numeric_limits<Real>::max();
+        hi[idim] = chi[idim] = std::numeric_limits<Real>::lowest();
+    }
+    for (int k = begin; k < end; ++k) {
+        const int i = m_prim[k];
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            lo[idim] = std::min(lo[idim], m_lo[i][idim]);
+            hi[idim] = std::max(hi[idim], m_hi[i][idim]);
+            // Halve first so that unbounded directions do not overflow.
+            const Real c = 0.5*m_lo[i][idim] + 0.5*m_hi[i][idim];
+            clo[idim] = std::min(clo[idim], c);
+            chi[idim] = std::max(chi[idim], c);
+        }
+    }
+    m_node[inode].lo = lo;
+    m_node[inode].hi = hi;
+
+    if (end - begin <= m_leaf_size) {
+        m_node[inode].begin = begin;
+        m_node[inode].end = end;
+        return inode;
+    }
+
+    // Split at the median of the box centers along the longest direction.
+    int dir = 0;
+    for (int idim = 1; idim < AMREX_SPACEDIM; ++idim) {
+        if (chi[idim]-clo[idim] > chi[dir]-clo[dir]) dir = idim;
+    }
+
+    const int mid = (begin + end) / 2;
+    std::nth_element(m_prim.begin()+begin, m_prim.begin()+mid, m_prim.begin()+end,
+                     [&] (int a, int b) -> bool {
+                         return (0.5*m_lo[a][dir] + 0.5*m_hi[a][dir])
+                             <  (0.5*m_lo[b][dir] + 0.5*m_hi[b][dir]);
+                     });
+
+    const int left  = build(begin, mid, depth+1);
+    const int right = build(mid  , end, depth+1);
+    m_node[inode].left  = left;
+    m_node[inode].right = right;
+
+    return inode;
+}
+
+}}
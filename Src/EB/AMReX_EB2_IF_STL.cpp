@@ -0,0 +1,268 @@
+
+#include <AMReX_EB2_IF_STL.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace amrex { namespace EB2 {
+
+#if (AMREX_SPACEDIM == 3)
+
+namespace {
+
+    inline RealArray sub (const RealArray& a, const RealArray& b) noexcept {
+        return RealArray{{a[0]-b[0], a[1]-b[1], a[2]-b[2]}};
+    }
+
+    inline Real dot (const RealArray& a, const RealArray& b) noexcept {
+        return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+    }
+
+    inline RealArray cross (const RealArray& a, const RealArray& b) noexcept {
+        return RealArray{{a[1]*b[2]-a[2]*b[1], a[2]*b[0]-a[0]*b[2], a[0]*b[1]-a[1]*b[0]}};
+    }
+
+    inline Real norm (const RealArray& a) noexcept {
+        return std::sqrt(dot(a,a));
+    }
+
+    inline void axpy (RealArray& y, Real a, const RealArray& x) noexcept {
+        y[0] += a*x[0];
+        y[1] += a*x[1];
+        y[2] += a*x[2];
+    }
+
+    inline Real angle (const RealArray& a, const RealArray& b) noexcept {
+        Real c = dot(a,b) / (norm(a)*norm(b));
+        return std::acos(amrex::max(Real(-1.0),amrex::min(Real(1.0),c)));
+    }
+
+    void readSTL (const std::string& name, Vector<RealArray>& vertices)
+    {
+        Vector<char> buf;
+        ParallelDescriptor::ReadAndBcastFile(name, buf);
+        const Long nbytes = buf.size() - 1;  // ReadAndBcastFile appends '\0'
+
+        // A binary STL file has an 80-byte header, the number of
+        // triangles, and 50 bytes per triangle.
+        bool binary = false;
+        std::uint32_t ntri = 0;
+        if (nbytes >= 84) {
+            std::memcpy(&ntri, buf.data()+80, sizeof(std::uint32_t));
+            binary = (nbytes == 84 + 50*Long(ntri));
+        }
+
+        vertices.clear();
+        if (binary) {
+            vertices.reserve(3*ntri);
+            const char* p = buf.data() + 84;
+            for (std::uint32_t i = 0; i < ntri; ++i) {
+                float v[12];  // normal followed by three vertices
+                std::memcpy(v, p, sizeof(v));
+                for (int iv = 1; iv <= 3; ++iv) {
+                    vertices.push_back(RealArray{{v[3*iv], v[3*iv+1], v[3*iv+2]}});
+                }
+                p += 50;
+            }
+        } else {
+            std::istringstream is(std::string(buf.data(), nbytes));
+            std::string word;
+            while (is >> word) {
+                if (word == "vertex") {
+                    RealArray v;
+                    is >> v[0] >> v[1] >> v[2];
+                    vertices.push_back(v);
+                }
+            }
+            if (vertices.size() % 3 != 0) {
+                amrex::Abort("EB2::STLIF: failed to read "+name);
+            }
+        }
+    }
+}
+
+STLIF::STLIF (const std::string& a_name, bool a_inside, Real a_scale, const RealArray& a_center)
+    : m_sign( a_inside ? 1.0 : -1.0 )
+{
+    Vector<RealArray> vertices;
+    readSTL(a_name, vertices);
+    for (auto& v : vertices) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            v[idim] = v[idim]*a_scale + a_center[idim];
+        }
+    }
+    define(vertices);
+}
+
+STLIF::STLIF (const Vector<RealArray>& a_vertices, bool a_inside)
+    : m_sign( a_inside ? 1.0 : -1.0 )
+{
+    define(a_vertices);
+}
+
+void
+STLIF::define (const Vector<RealArray>& a_vertices)
+{
+    AMREX_ALWAYS_ASSERT(a_vertices.size() % 3 == 0);
+
+    m_data = std::make_shared<Data>();
+    auto& vertex = m_data->vertex;
+    auto& vertex_normal = m_data->vertex_normal;
+    auto& tri = m_data->tri;
+
+    // STL files store each triangle separately, so identical vertices
+    // have to be merged to find the neighbors needed by pseudo-normals.
+    std::map<RealArray,int> vertex_index;
+    const int ntri_in = a_vertices.size() / 3;
+    tri.reserve(ntri_in);
+    for (int it = 0; it < ntri_in; ++it)
+    {
+        Triangle t;
+        for (int iv = 0; iv < 3; ++iv) {
+            const RealArray& v = a_vertices[3*it+iv];
+            auto r = vertex_index.insert(std::make_pair(v, static_cast<int>(vertex.size())));
+            if (r.second) vertex.push_back(v);
+            t.v[iv] = r.first->second;
+        }
+        RealArray n = cross(sub(vertex[t.v[1]],vertex[t.v[0]]),
+                            sub(vertex[t.v[2]],vertex[t.v[0]]));
+        Real area2 = norm(n);
+        if (area2 > 0.0) {  // Skip degenerate triangles
+            for (auto& x : n) x /= area2;
+            t.normal = n;
+            tri.push_back(t);
+        }
+    }
+
+    const RealArray zero{{0.0,0.0,0.0}};
+    vertex_normal.assign(vertex.size(), zero);
+    std::map<std::pair<int,int>,RealArray> edge_normal;
+    for (const auto& t : tri) {
+        for (int iv = 0; iv < 3; ++iv) {
+            const int a = t.v[iv];
+            const int b = t.v[(iv+1)%3];
+            const int c = t.v[(iv+2)%3];
+            axpy(vertex_normal[a], angle(sub(vertex[b],vertex[a]), sub(vertex[c],vertex[a])),
+                 t.normal);
+            auto r = edge_normal.insert(std::make_pair(std::make_pair(std::min(a,b),std::max(a,b)),
+                                                       zero));
+            axpy(r.first->second, 1.0, t.normal);
+        }
+    }
+
+    const int ntri = tri.size();
+    Vector<RealArray> lo(ntri), hi(ntri);
+    for (int it = 0; it < ntri; ++it) {
+        auto& t = tri[it];
+        for (int iv = 0; iv < 3; ++iv) {
+            const int a = t.v[iv];
+            const int b = t.v[(iv+1)%3];
+            t.edge_normal[iv] = edge_normal[std::make_pair(std::min(a,b),std::max(a,b))];
+        }
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            lo[it][idim] = std::min({vertex[t.v[0]][idim], vertex[t.v[1]][idim], vertex[t.v[2]][idim]});
+            hi[it][idim] = std::max({vertex[t.v[0]][idim], vertex[t.v[1]][idim], vertex[t.v[2]][idim]});
+        }
+    }
+
+    m_data->bvh.define(lo, hi);
+}
+
+RealArray
+STLIF::closestPoint (const RealArray& p, int it, int& region) const
+{
+    // Ericson, Real-Time Collision Detection, Section 5.1.5
+    const Triangle& t = m_data->tri[it];
+    const RealArray& a = m_data->vertex[t.v[0]];
+    const RealArray& b = m_data->vertex[t.v[1]];
+    const RealArray& c = m_data->vertex[t.v[2]];
+
+    const RealArray ab = sub(b,a);
+    const RealArray ac = sub(c,a);
+    const RealArray ap = sub(p,a);
+    const Real d1 = dot(ab,ap);
+    const Real d2 = dot(ac,ap);
+    if (d1 <= 0.0 && d2 <= 0.0) {
+        region = 1;
+        return a;
+    }
+
+    const RealArray bp = sub(p,b);
+    const Real d3 = dot(ab,bp);
+    const Real d4 = dot(ac,bp);
+    if (d3 >= 0.0 && d4 <= d3) {
+        region = 2;
+        return b;
+    }
+
+    const Real vc = d1*d4 - d3*d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+        region = 4;
+        RealArray r = a;
+        axpy(r, d1/(d1-d3), ab);
+        return r;
+    }
+
+    const RealArray cp = sub(p,c);
+    const Real d5 = dot(ab,cp);
+    const Real d6 = dot(ac,cp);
+    if (d6 >= 0.0 && d5 <= d6) {
+        region = 3;
+        return c;
+    }
+
+    const Real vb = d5*d2 - d1*d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+        region = 6;
+        RealArray r = a;
+        axpy(r, d2/(d2-d6), ac);
+        return r;
+    }
+
+    const Real va = d3*d6 - d5*d4;
+    if (va <= 0.0 && (d4-d3) >= 0.0 && (d5-d6) >= 0.0) {
+        region = 5;
+        RealArray r = b;
+        axpy(r, (d4-d3)/((d4-d3)+(d5-d6)), sub(c,b));
+        return r;
+    }
+
+    region = 0;
+    const Real denom = 1.0/(va+vb+vc);
+    RealArray r = a;
+    axpy(r, vb*denom, ab);
+    axpy(r, vc*denom, ac);
+    return r;
+}
+
+Real
+STLIF::operator() (const RealArray& p) const
+{
+    int region;
+    int it;
+    const Real dist = m_data->bvh.nearest(p, [&] (int i) -> Real
+                                          { return norm(sub(p,closestPoint(p,i,region))); },
+                                          it);
+    AMREX_ASSERT(it >= 0);
+
+    const RealArray cp = closestPoint(p, it, region);
+    const Triangle& t = m_data->tri[it];
+    const RealArray& n = (region == 0) ? t.normal
+                       : (region <= 3) ? m_data->vertex_normal[t.v[region-1]]
+                       :                 t.edge_normal[region-4];
+
+    // Positive outside the surface
+    const Real d = (dot(sub(p,cp),n) >= 0.0) ? dist : -dist;
+    return m_sign*d;
+}
+
+#endif
+
+}}
@@ -1,7 +1,10 @@
 
 #include <AMReX_EB2_Level.H>
 #include <AMReX_IArrayBox.H>
+#include <AMReX_Utility.H>
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -871,4 +874,137 @@ Level::fillLevelSet (MultiFab& levelset, const Geometry& geom) const
     }
 }
         
+void
+Level::write (const std::string& dirname) const
+{
+    BL_PROFILE("EB2::Level::write()");
+
+    if (ParallelDescriptor::IOProcessor()) {
+        if (!amrex::UtilCreateDirectory(dirname, 0755)) {
+            amrex::CreateDirectoryFailed(dirname);
+        }
+
+        std::string const& hname = dirname + "/Header";
+        std::ofstream hfile(hname.c_str(), std::ios::out | std::ios::trunc);
+        if (!hfile.good()) {
+            amrex::FileOpenFailed(hname);
+        }
+        hfile << "EB2::Level_V1\n"
+              << m_allregular << '\n'
+              << m_ok << '\n'
+              << m_ngrow << '\n';
+        m_grids.writeOn(hfile);
+        hfile << '\n';
+        m_covered_grids.writeOn(hfile);
+        hfile << '\n';
+    }
+    ParallelDescriptor::Barrier("EB2::Level::write");
+
+    if (m_allregular || m_grids.empty()) return;
+
+    VisMF::Write(m_levelset, dirname+"/LevelSet");
+    VisMF::Write(m_volfrac, dirname+"/VolFrac");
+    VisMF::Write(m_centroid, dirname+"/Centroid");
+    VisMF::Write(m_bndryarea, dirname+"/BndryArea");
+    VisMF::Write(m_bndrycent, dirname+"/BndryCent");
+    VisMF::Write(m_bndrynorm, dirname+"/BndryNorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        VisMF::Write(m_areafrac[idim], dirname+"/AreaFrac_"+std::to_string(idim));
+        VisMF::Write(m_facecent[idim], dirname+"/FaceCent_"+std::to_string(idim));
+    }
+
+    // The flags are stored as two 16-bit halves so that they are exact
+    // even with single precision Real.
+    MultiFab flag(m_cellflag.boxArray(), m_cellflag.DistributionMap(), 2, m_cellflag.nGrow());
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(flag); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.fabbox();
+        auto const& cflag = m_cellflag.const_array(mfi);
+        auto const& rflag = flag.array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+        {
+            const uint32_t v = cflag(i,j,k).getValue();
+            rflag(i,j,k,0) = static_cast<Real>(v & 0xffff);
+            rflag(i,j,k,1) = static_cast<Real>(v >> 16);
+        });
+    }
+    VisMF::Write(flag, dirname+"/CellFlag");
+}
+
+void
+Level::read (const std::string& dirname)
+{
+    BL_PROFILE("EB2::Level::read()");
+
+    {
+        std::string const& hname = dirname + "/Header";
+        Vector<char> fileCharPtr;
+        ParallelDescriptor::ReadAndBcastFile(hname, fileCharPtr);
+        std::string fileCharPtrString(fileCharPtr.dataPtr());
+        std::istringstream is(fileCharPtrString, std::istringstream::in);
+
+        std::string version;
+        is >> version;
+        if (version != "EB2::Level_V1") {
+            amrex::Abort("EB2::Level::read: unknown version "+version+" in "+hname);
+        }
+        is >> m_allregular >> m_ok >> m_ngrow;
+        m_grids.readFrom(is);
+        m_covered_grids.readFrom(is);
+    }
+
+    if (m_allregular || m_grids.empty()) return;
+
+    m_dmap = DistributionMapping(m_grids);
+
+    const int ng = 2;
+    MFInfo mf_info;
+    mf_info.SetTag("EB2::Level");
+    m_levelset.define(amrex::convert(m_grids,IntVect::TheNodeVector()), m_dmap, 1, 0, mf_info);
+    m_cellflag.define(m_grids, m_dmap, 1, ng, mf_info);
+    m_volfrac.define(m_grids, m_dmap, 1, ng, mf_info);
+    m_centroid.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    m_bndryarea.define(m_grids, m_dmap, 1, ng, mf_info);
+    m_bndrycent.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    m_bndrynorm.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        m_areafrac[idim].define(amrex::convert(m_grids, IntVect::TheDimensionVector(idim)),
+                                m_dmap, 1, ng, mf_info);
+        m_facecent[idim].define(amrex::convert(m_grids, IntVect::TheDimensionVector(idim)),
+                                m_dmap, AMREX_SPACEDIM-1, ng, mf_info);
+    }
+
+    VisMF::Read(m_levelset, dirname+"/LevelSet");
+    VisMF::Read(m_volfrac, dirname+"/VolFrac");
+    VisMF::Read(m_centroid, dirname+"/Centroid");
+    VisMF::Read(m_bndryarea, dirname+"/BndryArea");
+    VisMF::Read(m_bndrycent, dirname+"/BndryCent");
+    VisMF::Read(m_bndrynorm, dirname+"/BndryNorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        VisMF::Read(m_areafrac[idim], dirname+"/AreaFrac_"+std::to_string(idim));
+        VisMF::Read(m_facecent[idim], dirname+"/FaceCent_"+std::to_string(idim));
+    }
+
+    MultiFab flag(m_grids, m_dmap, 2, ng);
+    VisMF::Read(flag, dirname+"/CellFlag");
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(flag); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.fabbox();
+        auto const& cflag = m_cellflag.array(mfi);
+        auto const& rflag = flag.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+        {
+            const uint32_t lo = static_cast<uint32_t>(rflag(i,j,k,0));
+            const uint32_t hi = static_cast<uint32_t>(rflag(i,j,k,1));
+            cflag(i,j,k) = EBCellFlag((hi << 16) | lo);
+        });
+    }
+}
+
 }}
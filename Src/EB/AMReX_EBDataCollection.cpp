@@ -2,6 +2,7 @@
 #include <AMReX_EBDataCollection.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_MultiCutFab.H>
+#include <AMReX_SparseCutFab.H>
 
 #include <AMReX_EB2_Level.H>
 
@@ -71,6 +72,15 @@ EBDataCollection::~EBDataCollection ()
         delete m_areafrac[idim];
         delete m_facecent[idim];
     }
+    delete m_sparse_volfrac;
+    delete m_sparse_centroid;
+    delete m_sparse_bndrycent;
+    delete m_sparse_bndryarea;
+    delete m_sparse_bndrynorm;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        delete m_sparse_areafrac[idim];
+        delete m_sparse_facecent[idim];
+    }
 }
 
 const FabArray<EBCellFlagFab>&
@@ -129,4 +139,88 @@ EBDataCollection::getBndryNormal () const
     return *m_bndrynorm;
 }
 
+// The sparse copies are built on first use.  The defaults are the values
+// EB2::Level uses for regular and covered cells.
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseVolFrac () const
+{
+    AMREX_ASSERT(m_volfrac != nullptr);
+    std::lock_guard<std::mutex> lock(m_sparse_mutex);
+    if (m_sparse_volfrac == nullptr) {
+        m_sparse_volfrac = new MultiSparseCutFab(*m_volfrac, *m_cellflags, 1.0, 0.0);
+    }
+    return *m_sparse_volfrac;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseCentroid () const
+{
+    AMREX_ASSERT(m_centroid != nullptr);
+    std::lock_guard<std::mutex> lock(m_sparse_mutex);
+    if (m_sparse_centroid == nullptr) {
+        m_sparse_centroid = new MultiSparseCutFab(*m_centroid, 0.0, 0.0);
+    }
+    return *m_sparse_centroid;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryCent () const
+{
+    AMREX_ASSERT(m_bndrycent != nullptr);
+    std::lock_guard<std::mutex> lock(m_sparse_mutex);
+    if (m_sparse_bndrycent == nullptr) {
+        m_sparse_bndrycent = new MultiSparseCutFab(*m_bndrycent, -1.0, -1.0);
+    }
+    return *m_sparse_bndrycent;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryArea () const
+{
+    AMREX_ASSERT(m_bndryarea != nullptr);
+    std::lock_guard<std::mutex> lock(m_sparse_mutex);
+    if (m_sparse_bndryarea == nullptr) {
+        m_sparse_bndryarea = new MultiSparseCutFab(*m_bndryarea, 0.0, 0.0);
+    }
+    return *m_sparse_bndryarea;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryNormal () const
+{
+    AMREX_ASSERT(m_bndrynorm != nullptr);
+    std::lock_guard<std::mutex> lock(m_sparse_mutex);
+    if (m_sparse_bndrynorm == nullptr) {
+        m_sparse_bndrynorm = new MultiSparseCutFab(*m_bndrynorm, 0.0, 0.0);
+    }
+    return *m_sparse_bndrynorm;
+}
+
+Array<const MultiSparseCutFab*, AMREX_SPACEDIM>
+EBDataCollection::getSparseAreaFrac () const
+{
+    AMREX_ASSERT(m_areafrac[0] != nullptr);
+    std::lock_guard<std::mutex> lock(m_sparse_mutex);
+    if (m_sparse_areafrac[0] == nullptr) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            m_sparse_areafrac[idim] = new MultiSparseCutFab(*m_areafrac[idim], 1.0, 0.0);
+        }
+    }
+    return {AMREX_D_DECL(m_sparse_areafrac[0], m_sparse_areafrac[1], m_sparse_areafrac[2])};
+}
+
+Array<const MultiSparseCutFab*, AMREX_SPACEDIM>
+EBDataCollection::getSparseFaceCent () const
+{
+    AMREX_ASSERT(m_facecent[0] != nullptr);
+    std::lock_guard<std::mutex> lock(m_sparse_mutex);
+    if (m_sparse_facecent[0] == nullptr) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            m_sparse_facecent[idim] = new MultiSparseCutFab(*m_facecent[idim], 0.0, 0.0);
+        }
+    }
+    return {AMREX_D_DECL(m_sparse_facecent[0], m_sparse_facecent[1], m_sparse_facecent[2])};
+}
+
 }
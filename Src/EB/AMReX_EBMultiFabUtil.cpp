@@ -813,7 +813,7 @@ EB_interp_CC_to_Centroid (MultiFab& cent, const MultiFab& cc, int scomp, int dco
 {
     const auto& factory = dynamic_cast<EBFArrayBoxFactory const&>(cc.Factory());
     const auto& flags = factory.getMultiEBCellFlagFab();
-    const auto& loc = factory.getCentroid();
+    const auto& loc = factory.getSparseCentroid();
 
     MFItInfo mfi_info;
     if (Gpu::notInLaunchRegion()) mfi_info.SetDynamic(true);
@@ -843,13 +843,18 @@ EB_interp_CC_to_Centroid (MultiFab& cent, const MultiFab& cc, int scomp, int dco
         }
         else
         {
-            const auto& flagfab = flags.const_array(mfi);
+            // Only the cut cells stored in the sparse centroid differ
+            // from the cell-centered values.
             const auto& locfab = loc.const_array(mfi);
-            const auto& ccfab = cc.array(mfi,scomp);
+            const auto& ccfab = cc.const_array(mfi,scomp);
 
-            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( vbx, thread_box,
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( vbx, ncomp, i, j, k, n,
+            {
+                centfab(i,j,k,n) = ccfab(i,j,k,n);
+            });
+            AMREX_HOST_DEVICE_FOR_1D ( locfab.nentries, m,
             {
-                eb_interp_cc2cent(thread_box, centfab, ccfab, flagfab, locfab, ncomp);
+                eb_interp_cc2cent_sparse(m, vbx, centfab, ccfab, locfab, ncomp);
             });
         }
     }
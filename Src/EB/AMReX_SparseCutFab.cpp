@@ -0,0 +1,205 @@
+
+#include <AMReX_SparseCutFab.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiFab.H>
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace amrex {
+
+namespace {
+    template <class T>
+    void setLayout (SparseCutArray4<T>& a, const Box& bx, Real regular_value, Real covered_value)
+    {
+        a.dir = -1;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (bx.type(idim) == IndexType::NODE) a.dir = idim;
+        }
+        const Dim3 hi = amrex::ubound(bx);
+        a.begin = amrex::lbound(bx);
+        a.end = Dim3{hi.x+1, hi.y+1, hi.z+1};
+        a.regular_value = regular_value;
+        a.covered_value = covered_value;
+    }
+}
+
+MultiSparseCutFab::MultiSparseCutFab (const MultiCutFab& src, Real regular_value, Real covered_value)
+{
+    define(src, regular_value, covered_value);
+}
+
+MultiSparseCutFab::MultiSparseCutFab (const MultiFab& src, const FabArray<EBCellFlagFab>& cellflags,
+                                      Real regular_value, Real covered_value)
+{
+    define(src, cellflags, regular_value, covered_value);
+}
+
+void
+MultiSparseCutFab::define (const BoxArray& ba, const DistributionMapping& dm, int ncomp, int ngrow,
+                           const FabArray<EBCellFlagFab>& cellflags,
+                           Real regular_value, Real covered_value)
+{
+    m_data.define(ba, dm);
+    m_cellflags = &cellflags;
+    m_ncomp = ncomp;
+    m_ngrow = ngrow;
+    m_regular_value = regular_value;
+    m_covered_value = covered_value;
+}
+
+void
+MultiSparseCutFab::define (const MultiCutFab& src, Real regular_value, Real covered_value)
+{
+    define(src.boxArray(), src.DistributionMap(), src.nComp(), src.nGrow(),
+           src.cellFlags(), regular_value, covered_value);
+
+    // The data are compressed on the host.
+    Gpu::synchronize();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi)
+    {
+        compress(mfi, src.ok(mfi) ? src.const_array(mfi) : Array4<Real const>());
+    }
+}
+
+void
+MultiSparseCutFab::define (const MultiFab& src, const FabArray<EBCellFlagFab>& cellflags,
+                           Real regular_value, Real covered_value)
+{
+    define(src.boxArray(), src.DistributionMap(), src.nComp(), src.nGrow(),
+           cellflags, regular_value, covered_value);
+
+    Gpu::synchronize();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi)
+    {
+        compress(mfi, src.const_array(mfi));
+    }
+}
+
+void
+MultiSparseCutFab::compress (const MFIter& mfi, Array4<Real const> const& src)
+{
+    Chunk& chunk = m_data[mfi];
+    chunk.idx.clear();
+    chunk.data.clear();
+    if (src.p == nullptr) return;
+
+    const SparseCutArray4<Real const> a = const_array(mfi);
+    const Box bx = amrex::grow(boxArray()[mfi.index()], m_ngrow);
+    const Dim3 lo = amrex::lbound(bx);
+    const Dim3 hi = amrex::ubound(bx);
+
+    Vector<int> idx;
+    for (int k = lo.z; k <= hi.z; ++k) {
+    for (int j = lo.y; j <= hi.y; ++j) {
+    for (int i = lo.x; i <= hi.x; ++i) {
+        const Real d = a.defaultValue(i,j,k);
+        for (int n = 0; n < m_ncomp; ++n) {
+            if (src(i,j,k,n) != d) {
+                idx.push_back(a.offset(i,j,k));
+                break;
+            }
+        }
+    }}}
+
+    const int nentries = idx.size();
+    chunk.idx.resize(nentries);
+    std::copy(idx.begin(), idx.end(), chunk.idx.begin());
+    chunk.data.resize(static_cast<Long>(nentries)*m_ncomp);
+
+    const SparseCutArray4<Real> b = array(mfi);
+    for (int m = 0; m < nentries; ++m) {
+        const Dim3 c = b.cell(m);
+        for (int n = 0; n < m_ncomp; ++n) {
+            b.value(m,n) = src(c.x,c.y,c.z,n);
+        }
+    }
+}
+
+SparseCutArray4<Real const>
+MultiSparseCutFab::const_array (const MFIter& mfi) const noexcept
+{
+    const Chunk& chunk = m_data[mfi];
+    SparseCutArray4<Real const> a;
+    a.flag = m_cellflags->const_array(mfi);
+    a.idx = chunk.idx.data();
+    a.p = chunk.data.data();
+    a.nentries = chunk.idx.size();
+    a.ncomp = m_ncomp;
+    setLayout(a, amrex::grow(boxArray()[mfi.index()], m_ngrow), m_regular_value, m_covered_value);
+    return a;
+}
+
+SparseCutArray4<Real const>
+MultiSparseCutFab::array (const MFIter& mfi) const noexcept
+{
+    return const_array(mfi);
+}
+
+SparseCutArray4<Real>
+MultiSparseCutFab::array (const MFIter& mfi) noexcept
+{
+    Chunk& chunk = m_data[mfi];
+    SparseCutArray4<Real> a;
+    a.flag = m_cellflags->const_array(mfi);
+    a.idx = chunk.idx.data();
+    a.p = chunk.data.data();
+    a.nentries = chunk.idx.size();
+    a.ncomp = m_ncomp;
+    setLayout(a, amrex::grow(boxArray()[mfi.index()], m_ngrow), m_regular_value, m_covered_value);
+    return a;
+}
+
+Long
+MultiSparseCutFab::numEntries () const noexcept
+{
+    Long n = 0;
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi) {
+        n += m_data[mfi].idx.size();
+    }
+    return n;
+}
+
+Long
+MultiSparseCutFab::nBytes () const noexcept
+{
+    Long n = 0;
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi) {
+        const Chunk& chunk = m_data[mfi];
+        n += chunk.idx.size()*sizeof(int) + chunk.data.size()*sizeof(Real);
+    }
+    return n;
+}
+
+MultiFab
+MultiSparseCutFab::ToMultiFab () const
+{
+    MultiFab mf(boxArray(), DistributionMap(), m_ncomp, m_ngrow);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& b = mfi.fabbox();
+        Array4<Real> const& d = mf.array(mfi);
+        SparseCutArray4<Real const> const s = const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D(b, m_ncomp, i, j, k, n,
+        {
+            d(i,j,k,n) = s(i,j,k,n);
+        });
+    }
+    return mf;
+}
+
+}
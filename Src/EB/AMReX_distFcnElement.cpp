@@ -1,5 +1,8 @@
 #include "AMReX_distFcnElement.H"
 
+#include <algorithm>
+#include <limits>
+
 /* ---------------------------------------------------------------------------*/
 /* Implementation for Distance Function 2D Base Class */
 /* ---------------------------------------------------------------------------*/
@@ -31,6 +34,11 @@ int distFcnElement2d::solve_thomas(const std::vector<amrex::Real> &a,
   return 0;
 }
 
+void distFcnElement2d::bounds(amrex::RealVect& lo, amrex::RealVect& hi) const {
+  lo = amrex::RealVect(std::numeric_limits<amrex::Real>::lowest());
+  hi = amrex::RealVect(std::numeric_limits<amrex::Real>::max());
+}
+
 }
 
 
@@ -167,6 +175,34 @@ amrex::Real SplineDistFcnElement2d::cpside(amrex::RealVect pt,
 }
 
 
+void SplineDistFcnElement2d::bounds(amrex::RealVect& lo,
+                                    amrex::RealVect& hi) const {
+  // Each segment is a cubic Hermite curve, which lies in the convex hull of
+  // its Bezier control points y0, y0+D0/3, y1-D1/3 and y1.
+  lo = amrex::RealVect(std::numeric_limits<amrex::Real>::lowest());
+  hi = amrex::RealVect(std::numeric_limits<amrex::Real>::max());
+  lo[0] = lo[1] = std::numeric_limits<amrex::Real>::max();
+  hi[0] = hi[1] = std::numeric_limits<amrex::Real>::lowest();
+  int nsplines = Dx.size() - 1;
+  for (int i=0; i<nsplines; ++i) {
+    const amrex::Real bx[4] = {control_points_x[i],
+                               control_points_x[i] + Dx[i]/3.0,
+                               control_points_x[i+1] - Dx[i+1]/3.0,
+                               control_points_x[i+1]};
+    const amrex::Real by[4] = {control_points_y[i],
+                               control_points_y[i] + Dy[i]/3.0,
+                               control_points_y[i+1] - Dy[i+1]/3.0,
+                               control_points_y[i+1]};
+    for (int j=0; j<4; ++j) {
+      lo[0] = std::min(lo[0], bx[j]);
+      hi[0] = std::max(hi[0], bx[j]);
+      lo[1] = std::min(lo[1], by[j]);
+      hi[1] = std::max(hi[1], by[j]);
+    }
+  }
+}
+
+
 void SplineDistFcnElement2d::single_spline_cpdist(amrex::RealVect pt,
                                     amrex::Real x0, amrex::Real x1,
                                     amrex::Real Dx0, amrex::Real Dx1,
@@ -351,6 +387,16 @@ amrex::Real LineDistFcnElement2d::cpdist(amrex::RealVect pt,
   return mindist;
 
 }
+void LineDistFcnElement2d::bounds(amrex::RealVect& lo,
+                                  amrex::RealVect& hi) const {
+  lo = amrex::RealVect(std::numeric_limits<amrex::Real>::lowest());
+  hi = amrex::RealVect(std::numeric_limits<amrex::Real>::max());
+  lo[0] = *std::min_element(control_points_x.begin(), control_points_x.end());
+  hi[0] = *std::max_element(control_points_x.begin(), control_points_x.end());
+  lo[1] = *std::min_element(control_points_y.begin(), control_points_y.end());
+  hi[1] = *std::max_element(control_points_y.begin(), control_points_y.end());
+}
+
 amrex::Real LineDistFcnElement2d::cpside(amrex::RealVect pt,
                                          amrex::RealVect & cpmin) const {
 
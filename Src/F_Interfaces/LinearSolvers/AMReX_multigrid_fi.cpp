@@ -91,6 +91,14 @@
              mlmg->setBottomSolver(MLMG::BottomSolver::hypre);
          } else if (s == 4) {
              mlmg->setBottomSolver(MLMG::BottomSolver::petsc);
+         } else if (s == 5) {
+             mlmg->setBottomSolver(MLMG::BottomSolver::pipelined_bicgstab);
+         } else if (s == 6) {
+             mlmg->setBottomSolver(MLMG::BottomSolver::pipelined_cg);
+         } else if (s == 7) {
+             mlmg->setBottomSolver(MLMG::BottomSolver::fft);
+         } else if (s == 8) {
+             mlmg->setBottomSolver(MLMG::BottomSolver::lu);
          } else {
              amrex::Abort("amrex_fi_multigrid_set_bottom_solver: unknown bottom solver");
          }
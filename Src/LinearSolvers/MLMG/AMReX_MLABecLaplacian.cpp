@@ -1,6 +1,7 @@
 
 #include <AMReX_MLABecLaplacian.H>
 #include <AMReX_MultiFabUtil.H>
+#include <algorithm>
 
 #include <AMReX_MLABecLap_K.H>
 
@@ -10,9 +11,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<BoxArray>& a_grids,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  int a_ncomp)
 {
-    define(a_geom, a_grids, a_dmap, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_info, a_factory, a_ncomp);
 }
 
 MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
@@ -20,9 +22,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const Vector<iMultiFab const*>& a_overset_mask,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  int a_ncomp)
 {
-    define(a_geom, a_grids, a_dmap, a_overset_mask, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_overset_mask, a_info, a_factory, a_ncomp);
 }
 
 void
@@ -30,34 +33,57 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<BoxArray>& a_grids,
                          const Vector<DistributionMapping>& a_dmap,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         int a_ncomp)
 {
     BL_PROFILE("MLABecLaplacian::define()");
 
-    MLCellABecLap::define(a_geom, a_grids, a_dmap, a_info, a_factory);
+    AMREX_ALWAYS_ASSERT(a_ncomp >= 1);
+    m_ncomp = a_ncomp;
 
-    const int ncomp = getNComp();
+    MLCellABecLap::define(a_geom, a_grids, a_dmap, a_info, a_factory);
 
     m_a_coeffs.resize(m_num_amr_levels);
-    m_b_coeffs.resize(m_num_amr_levels);
+    m_b_coeffs.clear();
     m_overset_mask.resize(m_num_amr_levels);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_a_coeffs[amrlev].resize(m_num_mg_levels[amrlev]);
-        m_b_coeffs[amrlev].resize(m_num_mg_levels[amrlev]);
         m_overset_mask[amrlev].resize(m_num_mg_levels[amrlev]);
         for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
         {
             m_a_coeffs[amrlev][mglev].define(m_grids[amrlev][mglev],
                                              m_dmap[amrlev][mglev],
                                              1, 0, MFInfo(), *m_factory[amrlev][mglev]);
+        }
+    }
+
+    // Independent components share a single b until per-component values are given.
+    defineBCoeffs((m_ncomp > 1) ? 1 : getNComp());
+}
+
+void
+MLABecLaplacian::defineBCoeffs (int nc)
+{
+    m_b_coeffs.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_b_coeffs[amrlev].resize(m_num_mg_levels[amrlev]);
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
             for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
             {
+                MultiFab& b = m_b_coeffs[amrlev][mglev][idim];
                 const BoxArray& ba = amrex::convert(m_grids[amrlev][mglev],
                                                     IntVect::TheDimensionVector(idim));
-                m_b_coeffs[amrlev][mglev][idim].define(ba,
-                                                       m_dmap[amrlev][mglev],
-                                                       ncomp, 0, MFInfo(), *m_factory[amrlev][mglev]);
+                MultiFab newb(ba, m_dmap[amrlev][mglev], nc, 0, MFInfo(),
+                              *m_factory[amrlev][mglev]);
+                if (b.ok()) {
+                    for (int icomp = 0; icomp < nc; ++icomp) {
+                        MultiFab::Copy(newb, b, 0, icomp, 1, 0);
+                    }
+                }
+                std::swap(b, newb);
             }
         }
     }
@@ -69,7 +95,8 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<DistributionMapping>& a_dmap,
                          const Vector<iMultiFab const*>& a_overset_mask,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         int a_ncomp)
 {
     BL_PROFILE("MLABecLaplacian::define(overset)");
 
@@ -129,7 +156,7 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
     LPInfo linfo = a_info;
     linfo.max_coarsening_level = std::min(a_info.max_coarsening_level,
                                           max_overset_mask_coarsening_level);
-    define(a_geom, a_grids, a_dmap, linfo, a_factory);
+    define(a_geom, a_grids, a_dmap, linfo, a_factory, a_ncomp);
 
     amrlev = 0;
     for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev) {
@@ -164,6 +191,7 @@ MLABecLaplacian::setScalars (Real a, Real b) noexcept
             m_a_coeffs[amrlev][0].setVal(0.0);
         }
     }
+    m_needs_update = true;
 }
 
 void
@@ -185,19 +213,18 @@ MLABecLaplacian::setBCoeffs (int amrlev,
                              const Array<MultiFab const*,AMREX_SPACEDIM>& beta)
 {
     const int ncomp = getNComp();
-    AMREX_ALWAYS_ASSERT(beta[0]->nComp() == 1 or beta[0]->nComp() == ncomp);
-    if (beta[0]->nComp() == ncomp)
-        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-            for (int icomp = 0; icomp < ncomp; ++icomp) {
-                MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim], icomp, icomp, 1, 0);
-            }
-        }
-    else 
-        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-            for (int icomp = 0; icomp < ncomp; ++icomp) {
-                MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim], 0, icomp, 1, 0);
-            }
+    const int bcomp = beta[0]->nComp();
+    AMREX_ALWAYS_ASSERT(bcomp == 1 or bcomp == ncomp);
+    if (bcomp > m_b_coeffs[amrlev][0][0].nComp()) {
+        defineBCoeffs(bcomp);
+    }
+    const int nc = m_b_coeffs[amrlev][0][0].nComp();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        for (int icomp = 0; icomp < nc; ++icomp) {
+            MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim],
+                           (bcomp == 1) ? 0 : icomp, icomp, 1, 0);
         }
+    }
     m_needs_update = true;
 }
 
@@ -214,9 +241,17 @@ void
 MLABecLaplacian::setBCoeffs (int amrlev, Vector<Real> const& beta)
 {
     const int ncomp = getNComp();
+    AMREX_ALWAYS_ASSERT(beta.size() >= ncomp);
+    if (m_b_coeffs[amrlev][0][0].nComp() < ncomp &&
+        std::any_of(beta.begin(), beta.begin()+ncomp,
+                    [&beta] (Real x) { return x != beta[0]; }))
+    {
+        defineBCoeffs(ncomp);
+    }
+    const int nc = m_b_coeffs[amrlev][0][0].nComp();
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-        for (int icomp = 0; icomp < ncomp; ++icomp) {
-            m_b_coeffs[amrlev][0][idim].setVal(beta[icomp]);
+        for (int icomp = 0; icomp < nc; ++icomp) {
+            m_b_coeffs[amrlev][0][idim].setVal(beta[icomp], icomp, 1);
         }
     }
     m_needs_update = true;
@@ -272,7 +307,7 @@ MLABecLaplacian::averageDownCoeffsSameAmrLevel (int amrlev, Vector<MultiFab>& a,
         if (m_overset_mask[amrlev][mglev]) {
             const Real fac = static_cast<Real>(1 << mglev); // 2**mglev
             const Real osfac = 2.0*fac/(fac+1.0);
-            const int ncomp = getNComp();
+            const int ncomp = b[mglev][0].nComp();
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -405,9 +440,9 @@ MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
         const auto& xfab = in.array(mfi);
         const auto& yfab = out.array(mfi);
         const auto& afab = acoef.array(mfi);
-        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
-                     const auto& byfab = bycoef.array(mfi);,
-                     const auto& bzfab = bzcoef.array(mfi););
+        AMREX_D_TERM(const auto& bxfab = bcoefArray(bxcoef.const_array(mfi), ncomp);,
+                     const auto& byfab = bcoefArray(bycoef.const_array(mfi), ncomp);,
+                     const auto& bzfab = bcoefArray(bzcoef.const_array(mfi), ncomp););
         if (m_overset_mask[amrlev][mglev]) {
             const auto& osm = m_overset_mask[amrlev][mglev]->array(mfi);
             AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA ( bx, tbx,
@@ -450,9 +485,9 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
         const Box& bx = mfi.tilebox();
         const auto& fab = mf.array(mfi);
         const auto& afab = acoef.array(mfi);
-        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
-                     const auto& byfab = bycoef.array(mfi);,
-                     const auto& bzfab = bzcoef.array(mfi););
+        AMREX_D_TERM(const auto& bxfab = bcoefArray(bxcoef.const_array(mfi), ncomp);,
+                     const auto& byfab = bcoefArray(bycoef.const_array(mfi), ncomp);,
+                     const auto& bzfab = bcoefArray(bzcoef.const_array(mfi), ncomp););
 
         AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA ( bx, tbx,
         {
@@ -535,9 +570,9 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
         const auto& rhsfab  = rhs.array(mfi);
         const auto& afab    = acoef.array(mfi);
 
-        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
-                     const auto& byfab = bycoef.array(mfi);,
-                     const auto& bzfab = bzcoef.array(mfi););
+        AMREX_D_TERM(const auto& bxfab = bcoefArray(bxcoef.const_array(mfi), nc);,
+                     const auto& byfab = bcoefArray(bycoef.const_array(mfi), nc);,
+                     const auto& bzfab = bcoefArray(bzcoef.const_array(mfi), nc););
 
         const auto& f0fab = f0.array(mfi);
         const auto& f1fab = f1.array(mfi);
@@ -651,6 +686,66 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     }
 }
 
+bool
+MLABecLaplacian::supportsFsmoothBox (int amrlev, int mglev, int nghost) const
+{
+    // The coefficients are only defined on the valid boxes, and
+    // MLTensorOp adds terms to apply that FresidualBox does not have.
+    bool regular_coarsening = true;
+    if (amrlev == 0 and mglev > 0) {
+        regular_coarsening = mg_coarsen_ratio_vec[mglev-1] == mg_coarsen_ratio;
+    }
+    return nghost == 0 && regular_coarsening && !m_overset_mask[amrlev][mglev] && !isTensorOp();
+}
+
+void
+MLABecLaplacian::FsmoothBox (int amrlev, int mglev, const MFIter& mfi, const Box& box, const Box& bbox,
+                             Array4<Real> const& sol, Array4<Real const> const& rhs,
+                             const Array<Array4<Real const>,2*AMREX_SPACEDIM>& f,
+                             const Array<Array4<int const>,2*AMREX_SPACEDIM>& m,
+                             int redblack) const
+{
+    const int ncomp = getNComp();
+    const auto& afab = m_a_coeffs[amrlev][mglev].const_array(mfi);
+    AMREX_D_TERM(const auto& bxfab = bcoefArray(m_b_coeffs[amrlev][mglev][0].const_array(mfi), ncomp);,
+                 const auto& byfab = bcoefArray(m_b_coeffs[amrlev][mglev][1].const_array(mfi), ncomp);,
+                 const auto& bzfab = bcoefArray(m_b_coeffs[amrlev][mglev][2].const_array(mfi), ncomp););
+
+    const Real* h = m_geom[amrlev][mglev].CellSize();
+    AMREX_D_TERM(const Real dhx = m_b_scalar/(h[0]*h[0]);,
+                 const Real dhy = m_b_scalar/(h[1]*h[1]);,
+                 const Real dhz = m_b_scalar/(h[2]*h[2]));
+
+    abec_gsrb(box, sol, rhs, m_a_scalar, afab,
+              AMREX_D_DECL(dhx, dhy, dhz),
+              AMREX_D_DECL(bxfab, byfab, bzfab),
+              AMREX_D_DECL(m[0],m[2],m[4]),
+              AMREX_D_DECL(m[1],m[3],m[5]),
+              AMREX_D_DECL(f[0],f[2],f[4]),
+              AMREX_D_DECL(f[1],f[3],f[5]),
+              bbox, redblack, ncomp);
+}
+
+void
+MLABecLaplacian::FresidualBox (int amrlev, int mglev, const MFIter& mfi, const Box& box,
+                               Array4<Real> const& resid, Array4<Real const> const& sol,
+                               Array4<Real const> const& rhs) const
+{
+    const int ncomp = getNComp();
+    const auto& afab = m_a_coeffs[amrlev][mglev].const_array(mfi);
+    AMREX_D_TERM(const auto& bxfab = bcoefArray(m_b_coeffs[amrlev][mglev][0].const_array(mfi), ncomp);,
+                 const auto& byfab = bcoefArray(m_b_coeffs[amrlev][mglev][1].const_array(mfi), ncomp);,
+                 const auto& bzfab = bcoefArray(m_b_coeffs[amrlev][mglev][2].const_array(mfi), ncomp););
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+
+    mlabeclap_adotx(box, resid, sol, afab, AMREX_D_DECL(bxfab,byfab,bzfab),
+                    dxinv, m_a_scalar, m_b_scalar, ncomp);
+    amrex::LoopConcurrentOnCpu(box, ncomp, [=] (int i, int j, int k, int n) noexcept
+    {
+        resid(i,j,k,n) = rhs(i,j,k,n) - resid(i,j,k,n);
+    });
+}
+
 void
 MLABecLaplacian::FFlux (int amrlev, const MFIter& mfi,
                         const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
@@ -675,9 +770,9 @@ MLABecLaplacian::FFlux (Box const& box, Real const* dxinv, Real bscalar,
                         Array<FArrayBox*,AMREX_SPACEDIM> const& flux,
                         FArrayBox const& sol, int face_only, int ncomp)
 {
-    AMREX_D_TERM(const auto bx = bcoef[0]->array();,
-                 const auto by = bcoef[1]->array();,
-                 const auto bz = bcoef[2]->array(););
+    AMREX_D_TERM(const auto bx = bcoefArray(bcoef[0]->const_array(), ncomp);,
+                 const auto by = bcoefArray(bcoef[1]->const_array(), ncomp);,
+                 const auto bz = bcoefArray(bcoef[2]->const_array(), ncomp););
     AMREX_D_TERM(const auto& fxarr = flux[0]->array();,
                  const auto& fyarr = flux[1]->array();,
                  const auto& fzarr = flux[2]->array(););
@@ -774,6 +869,8 @@ MLABecLaplacian::update ()
         }
     }
 
+    resetChebyshevSmooth();
+
     m_needs_update = false;
 }
 
@@ -48,6 +48,88 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0,nghost);
 }
 
+#ifdef BL_USE_MPI
+extern "C"
+void
+amrex_mlcg_sum_max (void* invec, void* inoutvec, int* len, MPI_Datatype* datatype)
+{
+    int nbytes;
+    MPI_Type_size(*datatype, &nbytes);
+    const int n = nbytes / sizeof(Real);
+    const Real* in = static_cast<const Real*>(invec);
+    Real* inout = static_cast<Real*>(inoutvec);
+    for (int k = 0; k < *len; ++k, in += n, inout += n)
+    {
+        for (int i = 0; i < n-1; ++i) {
+            inout[i] += in[i];
+        }
+        inout[n-1] = std::max(inout[n-1], in[n-1]);
+    }
+}
+#endif
+
+//
+// Reduces n local values in one nonblocking allreduce.  The first n-1
+// values are summed and the last one is a max norm.  The values are
+// passed as one element of a contiguous type, so that MPI cannot split
+// them up.
+//
+class FusedReduction
+{
+public:
+    FusedReduction (int n, MPI_Comm comm)
+        : m_comm(comm)
+    {
+#ifdef BL_USE_MPI
+        MPI_Type_contiguous(n, ParallelDescriptor::Mpi_typemap<Real>::type(), &m_type);
+        MPI_Type_commit(&m_type);
+        MPI_Op_create(amrex_mlcg_sum_max, 1, &m_op);
+#else
+        amrex::ignore_unused(n);
+#endif
+    }
+
+    ~FusedReduction ()
+    {
+        wait();
+#ifdef BL_USE_MPI
+        MPI_Op_free(&m_op);
+        MPI_Type_free(&m_type);
+#endif
+    }
+
+    FusedReduction (const FusedReduction& rhs) = delete;
+    FusedReduction& operator= (const FusedReduction& rhs) = delete;
+
+    //! vals must stay alive until wait returns.
+    void start (Real* vals)
+    {
+#ifdef BL_USE_MPI
+        MPI_Iallreduce(MPI_IN_PLACE, vals, 1, m_type, m_op, m_comm, &m_req);
+#else
+        amrex::ignore_unused(vals);
+#endif
+    }
+
+    void wait ()
+    {
+#ifdef BL_USE_MPI
+        if (m_req != MPI_REQUEST_NULL) {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            MPI_Wait(&m_req, MPI_STATUS_IGNORE);
+        }
+#endif
+    }
+
+private:
+    MPI_Comm m_comm;
+#ifdef BL_USE_MPI
+    MPI_Datatype m_type;
+    MPI_Op m_op;
+    MPI_Request m_req = MPI_REQUEST_NULL;
+#endif
+};
+
 }
 
 MLCGSolver::MLCGSolver (MLMG* a_mlmg, MLLinOp& _lp, Type _typ)
@@ -72,6 +154,10 @@ MLCGSolver::solve (MultiFab&       sol,
 {
     if (solver_type == Type::BiCGStab) {
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::PipelinedBiCGStab) {
+        return solve_pipelined_bicgstab(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::PipelinedCG) {
+        return solve_pipelined_cg(sol,rhs,eps_rel,eps_abs);
     } else {
         return solve_cg(sol,rhs,eps_rel,eps_abs);
     }
@@ -395,6 +481,371 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+int
+MLCGSolver::solve_pipelined_bicgstab (MultiFab&       sol,
+                                      const MultiFab& rhs,
+                                      Real            eps_rel,
+                                      Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipelined_bicgstab");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // The operator is applied to w and z, which need ghost cells.
+    MultiFab w(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab z(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    w.setVal(0.0);
+    z.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab y    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab t    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab v    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    FusedReduction reduction3(3, Lp.BottomCommunicator());
+    FusedReduction reduction5(5, Lp.BottomCommunicator());
+
+    // w = A r, t = A w
+    MultiFab::Copy(w,r,0,0,ncomp,nghost);
+    Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    Lp.normalize(amrlev, mglev, t);
+    MultiFab::Copy(w,t,0,0,ncomp,nghost);
+
+    Real rvals[5] = { dotxy(rh,r,true), dotxy(rh,w,true), norm_inf(r,true) };
+    reduction3.start(rvals);
+    Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    Lp.normalize(amrlev, mglev, t);
+    reduction3.wait();
+
+    Real rnorm = rvals[2];
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+    int ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+	{
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+	}
+        return ret;
+    }
+
+    Real rho = rvals[0];
+    Real alpha = 0, beta = 0, omega = 0;
+    if ( rho == 0 )
+    {
+        ret = 1;
+    }
+    else if ( rvals[1] == Real(0.0) )
+    {
+        ret = 2;
+    }
+    else
+    {
+        alpha = rho/rvals[1];
+    }
+
+    for (; ret == 0 && iter <= maxiter; ++iter)
+    {
+        if ( iter == 1 )
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(z,t,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(p, p, -omega, s, nghost);
+            sxay(p, r,   beta, p, nghost);
+            sxay(s, s, -omega, z, nghost);
+            sxay(s, w,   beta, s, nghost);
+            sxay(z, z, -omega, v, nghost);
+            sxay(z, t,   beta, z, nghost);
+        }
+        sxay(q, r, -alpha, s, nghost);
+        sxay(y, w, -alpha, z, nghost);
+
+        Real qvals[3] = { dotxy(q,y,true), dotxy(y,y,true), norm_inf(q,true) };
+        reduction3.start(qvals);
+        Lp.apply(amrlev, mglev, v, z, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, v);
+        reduction3.wait();
+
+        rnorm = qvals[2];
+
+        if ( verbose > 2 && ParallelDescriptor::IOProcessor() )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Half Iter "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+        {
+            sxay(sol, sol, alpha, p, nghost);
+            break;
+        }
+
+        if ( qvals[1] != Real(0.0) )
+	{
+            omega = qvals[0]/qvals[1];
+	}
+        else
+	{
+            ret = 3; break;
+	}
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(sol, sol, omega, q, nghost);
+        sxay(r,     q, -omega, y, nghost);
+        sxay(t,     t, -alpha, v, nghost);
+        sxay(w,     y, -omega, t, nghost);
+
+        rvals[0] = dotxy(rh,r,true);
+        rvals[1] = dotxy(rh,w,true);
+        rvals[2] = dotxy(rh,s,true);
+        rvals[3] = dotxy(rh,z,true);
+        rvals[4] = norm_inf(r,true);
+        reduction5.start(rvals);
+        Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, t);
+        reduction5.wait();
+
+        rnorm = rvals[4];
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Iteration "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( omega == 0 )
+	{
+            ret = 4; break;
+	}
+
+        const Real rho_1 = rho;
+        rho = rvals[0];
+        if ( rho == 0 )
+	{
+            ret = 1; break;
+	}
+        beta = (rho/rho_1)*(alpha/omega);
+        const Real denom = rvals[1] + beta*rvals[2] - beta*omega*rvals[3];
+        if ( denom != Real(0.0) )
+	{
+            alpha = rho/denom;
+	}
+        else
+	{
+            ret = 2; break;
+	}
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Final: Iteration "
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipelinedBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_pipelined_cg (MultiFab&       sol,
+                                const MultiFab& rhs,
+                                Real            eps_rel,
+                                Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipelined_cg");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // The operator is applied to w, which needs ghost cells.
+    MultiFab w(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    w.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    // w = A r
+    MultiFab::Copy(w,r,0,0,ncomp,nghost);
+    Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    MultiFab::Copy(w,q,0,0,ncomp,nghost);
+
+    FusedReduction reduction(3, Lp.BottomCommunicator());
+
+    Real rnorm = 0, rnorm0 = 0;
+    Real gamma_1 = 0, alpha_1 = 0;
+    int  ret = 0;
+
+    //
+    // The max norm of r is reduced together with the dot products of the
+    // next iteration, so iteration iter checks the residual of iter-1.
+    //
+    for (iter = 0; ; ++iter)
+    {
+        Real vals[3] = { dotxy(r,r,true), dotxy(w,r,true), norm_inf(r,true) };
+        reduction.start(vals);
+        Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        reduction.wait();
+
+        rnorm = vals[2];
+
+        if ( iter == 0 )
+        {
+            rnorm0 = rnorm;
+            if ( verbose > 0 )
+            {
+                amrex::Print() << "MLCGSolver_PipelinedCG: Initial error (error0) :        " << rnorm0 << '\n';
+            }
+            if ( rnorm0 == 0 || rnorm0 < eps_abs )
+            {
+                if ( verbose > 0 ) {
+                    amrex::Print() << "MLCGSolver_PipelinedCG: niter = 0,"
+                                   << ", rnorm = " << rnorm
+                                   << ", eps_abs = " << eps_abs << std::endl;
+                }
+                return ret;
+            }
+        }
+        else if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedCG: Iteration"
+                           << std::setw(4) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs || iter == maxiter ) break;
+
+        const Real gamma = vals[0];
+        const Real delta = (iter == 0) ? vals[1] : vals[1] - (gamma/gamma_1)*gamma/alpha_1;
+        if ( gamma == 0 || delta == Real(0.0) )
+        {
+            ret = 1; break;
+        }
+        const Real alpha = gamma/delta;
+
+        if ( iter == 0 )
+        {
+            MultiFab::Copy(z,q,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            const Real beta = gamma/gamma_1;
+            sxay(z, q, beta, z, nghost);
+            sxay(s, w, beta, s, nghost);
+            sxay(p, r, beta, p, nghost);
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedCG:"
+                           << " iter " << iter+1
+                           << " rho " << gamma
+                           << " alpha " << alpha << '\n';
+        }
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(  r,   r,-alpha, s, nghost);
+        sxay(  w,   w,-alpha, z, nghost);
+
+        gamma_1 = gamma;
+        alpha_1 = alpha;
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedCG: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipelinedCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
@@ -114,7 +114,8 @@ MLCellABecLap::applyInhomogNeumannTerm (int amrlev, MultiFab& rhs) const
 
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
         {
-            Array4<Real const> const bfab = (has_bcoef) ? bcoef[idim]->array(mfi) : foo.array();
+            Array4<Real const> const bfab = (has_bcoef)
+                ? bcoefArray(bcoef[idim]->const_array(mfi), ncomp) : foo.const_array();
             const Orientation olo(idim,Orientation::low);
             const Orientation ohi(idim,Orientation::high);
             const Box blo = amrex::adjCellLo(vbx, idim);
@@ -227,6 +228,85 @@ MLCellABecLap::applyInhomogNeumannTerm (int amrlev, MultiFab& rhs) const
     }
 }
 
+bool
+MLCellABecLap::supportsFdiagonal (int amrlev, int mglev) const
+{
+    return !m_has_metric_term && !isTensorOp() && getOversetMask(amrlev,mglev) == nullptr;
+}
+
+void
+MLCellABecLap::Fdiagonal (int amrlev, int mglev, MultiFab& diag) const
+{
+    BL_PROFILE("MLCellABecLap::Fdiagonal()");
+
+    const int ncomp = getNComp();
+    const Real ascalar = getAScalar();
+    const Real bscalar = getBScalar();
+    MultiFab const* acoef = getACoeffs(amrlev, mglev);
+    const Array<MultiFab const*,AMREX_SPACEDIM> bcoef = getBCoeffs(amrlev, mglev);
+    const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
+    const auto& maskvals  = m_maskvals [amrlev][mglev];
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(diag, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const Box& vbx = mfi.validbox();
+        const auto& d = diag.array(mfi);
+
+        if (acoef && ascalar != 0.0) {
+            const auto& a = acoef->const_array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                d(i,j,k,n) = ascalar*a(i,j,k);
+            });
+        } else {
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                d(i,j,k,n) = 0.0;
+            });
+        }
+
+        // The boundary stencil folds the ghost cell into the diagonal
+        // with the coefficients saved in m_undrrelxr.
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Real dh = bscalar*dxinv[idim]*dxinv[idim];
+            const Orientation olo(idim,Orientation::low);
+            const Orientation ohi(idim,Orientation::high);
+            const auto& flo = undrrelxr[olo][mfi].const_array();
+            const auto& fhi = undrrelxr[ohi][mfi].const_array();
+            const auto& mlo = maskvals[olo].array(mfi);
+            const auto& mhi = maskvals[ohi].array(mfi);
+            const int vlo = vbx.smallEnd(idim);
+            const int vhi = vbx.bigEnd(idim);
+            const IntVect e = IntVect::TheDimensionVector(idim);
+            if (bcoef[idim]) {
+                const auto& b = bcoefArray(bcoef[idim]->const_array(mfi), ncomp);
+                AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+                {
+                    const IntVect iv(AMREX_D_DECL(i,j,k));
+                    const IntVect ivh = iv + e;
+                    Real cl = (iv[idim] == vlo && mlo(iv-e) > 0) ? flo(iv,n) : 0.0;
+                    Real ch = (iv[idim] == vhi && mhi(ivh) > 0) ? fhi(iv,n) : 0.0;
+                    d(i,j,k,n) += dh*(b(iv,n)*(1.0-cl) + b(ivh,n)*(1.0-ch));
+                });
+            } else {
+                AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+                {
+                    const IntVect iv(AMREX_D_DECL(i,j,k));
+                    Real cl = (iv[idim] == vlo && mlo(iv-e) > 0) ? flo(iv,n) : 0.0;
+                    Real ch = (iv[idim] == vhi && mhi(iv+e) > 0) ? fhi(iv,n) : 0.0;
+                    d(i,j,k,n) += dh*((1.0-cl) + (1.0-ch));
+                });
+            }
+        }
+    }
+}
+
 #ifdef AMREX_USE_HYPRE
 std::unique_ptr<Hypre>
 MLCellABecLap::makeHypre (Hypre::Interface hypre_interface) const
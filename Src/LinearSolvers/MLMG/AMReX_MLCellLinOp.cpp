@@ -351,6 +351,10 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
     BL_PROFILE("MLCellLinOp::smooth()");
+    if (getChebyshevData(amrlev, mglev) != nullptr) {
+        chebyshevSmooth(amrlev, mglev, sol, rhs, info.chebyshev_degree, skip_fillboundary);
+        return;
+    }
     for (int redblack = 0; redblack < 2; ++redblack)
     {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
@@ -363,6 +367,681 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
     }
 }
 
+void
+MLCellLinOp::smoothSweeps (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                           int nsweeps, bool skip_fillboundary) const
+{
+    if (nsweeps > 0 && getChebyshevData(amrlev, mglev) != nullptr) {
+        chebyshevSmooth(amrlev, mglev, sol, rhs, nsweeps*info.chebyshev_degree, skip_fillboundary);
+        return;
+    }
+
+    CASmoothData* ca = (nsweeps > 1) ? getCASmoothData(amrlev, mglev) : nullptr;
+    if (ca == nullptr) {
+        MLLinOp::smoothSweeps(amrlev, mglev, sol, rhs, nsweeps, skip_fillboundary);
+        return;
+    }
+
+    BL_PROFILE("MLCellLinOp::smoothSweeps()");
+
+    // The grown boxes need all their ghost cells, so the first exchange
+    // cannot be skipped.
+    const int ncomp = getNComp();
+    const int nghost = ca->nghost;
+    const int nsweeps_per_fill = nghost/2;
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const int imaxorder = maxorder;
+    const Real* dxinv = geom.InvCellSize();
+
+    MultiFab::Copy(ca->sol, sol, 0, 0, ncomp, 0);
+    MultiFab::Copy(ca->rhs, rhs, 0, 0, ncomp, 0);
+    ca->rhs.FillBoundary(geom.periodicity());
+
+    FArrayBox foofab(Box::TheUnitBox(),ncomp);
+    const auto& foo = foofab.const_array();
+
+    for (int isweep = 0; isweep < nsweeps; isweep += nsweeps_per_fill)
+    {
+        ca->sol.FillBoundary(geom.periodicity());
+
+        const int ncolors = 2*std::min(nsweeps_per_fill, nsweeps-isweep);
+        for (int icolor = 0; icolor < ncolors; ++icolor)
+        {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            for (MFIter mfi(ca->sol, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+            {
+                const CASmoothBox& cab = ca->boxes[mfi];
+                const Box& bbx = cab.bbox;
+                const auto& solfab = ca->sol.array(mfi);
+
+                // Physical boundary conditions on the faces of the grown box
+                for (OrientationIter oitr; oitr; ++oitr)
+                {
+                    const Orientation ori = oitr();
+                    const int idim = ori.coordDir();
+                    const int side = ori.isLow() ? 0 : 1;
+                    const Box& b = amrex::adjCell(bbx, ori);
+                    const int blen = bbx.length(idim);
+                    const auto& m = cab.mask[ori].const_array();
+                    for (int icomp = 0; icomp < ncomp; ++icomp) {
+                        const BoundCond bct = cab.bcond[icomp][ori];
+                        const Real bcl = cab.bcloc[icomp][ori];
+                        if (idim == 0) {
+                            mllinop_apply_bc_x(side, b, blen, solfab, m, bct, bcl, foo,
+                                               imaxorder, dxinv[0], 0, icomp);
+                        }
+#if (AMREX_SPACEDIM > 1)
+                        else if (idim == 1) {
+                            mllinop_apply_bc_y(side, b, blen, solfab, m, bct, bcl, foo,
+                                               imaxorder, dxinv[1], 0, icomp);
+                        }
+#if (AMREX_SPACEDIM > 2)
+                        else {
+                            mllinop_apply_bc_z(side, b, blen, solfab, m, bct, bcl, foo,
+                                               imaxorder, dxinv[2], 0, icomp);
+                        }
+#endif
+#endif
+                    }
+                }
+
+                Array<Array4<Real const>,2*AMREX_SPACEDIM> f;
+                Array<Array4<int const>,2*AMREX_SPACEDIM> m;
+                for (OrientationIter oitr; oitr; ++oitr) {
+                    f[oitr()] = cab.undrrelxr[oitr()].const_array();
+                    m[oitr()] = cab.mask[oitr()].const_array();
+                }
+
+                // Cells within nghost-1-icolor of the valid box are up to date.
+                const Box& bx = amrex::grow(mfi.validbox(), nghost-1-icolor) & bbx;
+                FsmoothBox(amrlev, mglev, mfi, bx, bbx, solfab, ca->rhs.const_array(mfi), f, m, icolor%2);
+            }
+        }
+    }
+
+    MultiFab::Copy(sol, ca->sol, 0, 0, ncomp, 0);
+}
+
+MLCellLinOp::CASmoothData*
+MLCellLinOp::getCASmoothData (int amrlev, int mglev) const
+{
+    if (amrlev != 0 || info.comm_avoiding_sweeps < 2 || mglev < info.comm_avoiding_min_level) {
+        return nullptr;
+    }
+
+    if (m_ca_smooth_ok.empty()) {
+        m_ca_smooth.resize(m_num_mg_levels[0]);
+        m_ca_smooth_ok.resize(m_num_mg_levels[0], -1);
+    }
+
+    if (m_ca_smooth_ok[mglev] < 0)
+    {
+        // The grown boxes are treated like valid boxes, so this requires
+        // level 0 to cover the domain, and the same one-sided Dirichlet
+        // stencils for all boxes.
+        const BoxArray& ba = m_grids[0][mglev];
+        bool ok = m_domain_covered[0] && isCrossStencil() && supportsFsmoothBox(0, mglev, 2*info.comm_avoiding_sweeps)
+            && Gpu::notInLaunchRegion();
+        for (int i = 0, N = ba.size(); ok && i < N; ++i) {
+            ok = ba[i].shortside() >= maxorder-1;
+        }
+        // FillBoundary only shifts by one period, so the ghost cells of
+        // ca->sol must not reach beyond the next periodic image.
+        const Geometry& geom = m_geom[0][mglev];
+        for (int idim = 0; ok && idim < AMREX_SPACEDIM; ++idim) {
+            if (geom.isPeriodic(idim)) {
+                ok = geom.Domain().length(idim) >= 2*info.comm_avoiding_sweeps+1;
+            }
+        }
+        m_ca_smooth_ok[mglev] = ok;
+        if (!ok) return nullptr;
+
+        const int ncomp = getNComp();
+        const Box& domain = geom.Domain();
+        const Real* dx0 = m_geom[0][0].CellSize();
+        const Real* dxinv = geom.InvCellSize();
+        const int imaxorder = maxorder;
+
+        std::unique_ptr<CASmoothData> ca(new CASmoothData);
+        ca->nghost = 2*info.comm_avoiding_sweeps;
+        ca->sol.define(ba, m_dmap[0][mglev], ncomp, ca->nghost+1);
+        ca->rhs.define(ba, m_dmap[0][mglev], ncomp, ca->nghost);
+        ca->sol.setVal(0.0);
+        ca->boxes.define(ba, m_dmap[0][mglev]);
+
+        Box gdomain = domain;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (geom.isPeriodic(idim)) gdomain.grow(idim, ca->nghost);
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(ca->sol); mfi.isValid(); ++mfi)
+        {
+            CASmoothBox& cab = ca->boxes[mfi];
+            const Box& bbx = amrex::grow(mfi.validbox(), ca->nghost) & gdomain;
+            cab.bbox = bbx;
+            cab.bcond.resize(ncomp);
+            cab.bcloc.resize(ncomp);
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                MLMGBndry::setBoxBC(cab.bcloc[icomp], cab.bcond[icomp], bbx, domain,
+                                    m_lobc[icomp], m_hibc[icomp], dx0, 1, m_coarse_bc_loc,
+                                    m_domain_bloc_lo, m_domain_bloc_hi, geom.isPeriodicArray());
+            }
+
+            for (OrientationIter oitr; oitr; ++oitr)
+            {
+                const Orientation ori = oitr();
+                const int idim = ori.coordDir();
+                const int side = ori.isLow() ? 0 : 1;
+                const Box& b = amrex::adjCell(bbx, ori);
+                const int blen = bbx.length(idim);
+
+                cab.mask[ori].resize(b);
+                const bool physbndry = bbx[ori] == domain[ori] && !geom.isPeriodic(idim);
+                cab.mask[ori].setVal(physbndry ? BndryData::outside_domain : BndryData::covered);
+                const auto& m = cab.mask[ori].const_array();
+
+                cab.undrrelxr[ori].resize(amrex::shift(b, idim, ori.isLow() ? 1 : -1), ncomp);
+                const auto& f = cab.undrrelxr[ori].array();
+                for (int icomp = 0; icomp < ncomp; ++icomp) {
+                    const BoundCond bct = cab.bcond[icomp][ori];
+                    const Real bcl = cab.bcloc[icomp][ori];
+                    if (idim == 0) {
+                        mllinop_comp_interp_coef0_x(side, b, blen, f, m, bct, bcl,
+                                                    imaxorder, dxinv[0], icomp);
+                    }
+#if (AMREX_SPACEDIM > 1)
+                    else if (idim == 1) {
+                        mllinop_comp_interp_coef0_y(side, b, blen, f, m, bct, bcl,
+                                                    imaxorder, dxinv[1], icomp);
+                    }
+#if (AMREX_SPACEDIM > 2)
+                    else {
+                        mllinop_comp_interp_coef0_z(side, b, blen, f, m, bct, bcl,
+                                                    imaxorder, dxinv[2], icomp);
+                    }
+#endif
+#endif
+                }
+            }
+        }
+
+        m_ca_smooth[mglev] = std::move(ca);
+    }
+
+    return m_ca_smooth[mglev].get();
+}
+
+void
+MLCellLinOp::FsmoothBox (int, int, const MFIter&, const Box&, const Box&,
+                         Array4<Real> const&, Array4<Real const> const&,
+                         const Array<Array4<Real const>,2*AMREX_SPACEDIM>&,
+                         const Array<Array4<int const>,2*AMREX_SPACEDIM>&,
+                         int) const
+{
+    amrex::Abort("MLCellLinOp::FsmoothBox: not implemented");
+}
+
+void
+MLCellLinOp::FresidualBox (int, int, const MFIter&, const Box&, Array4<Real> const&,
+                           Array4<Real const> const&, Array4<Real const> const&) const
+{
+    amrex::Abort("MLCellLinOp::FresidualBox: not implemented");
+}
+
+void
+MLCellLinOp::smoothCorrectionResidual (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                                       MultiFab& resid, int nsweeps, bool skip_fillboundary)
+{
+    if (!info.do_fused_smooth_residual || nsweeps < 1 || !supportsFsmoothBox(amrlev, mglev, 0)
+        || Gpu::inLaunchRegion() || getCASmoothData(amrlev, mglev) != nullptr
+        || getChebyshevData(amrlev, mglev) != nullptr)
+    {
+        MLLinOp::smoothCorrectionResidual(amrlev, mglev, sol, rhs, resid, nsweeps, skip_fillboundary);
+        return;
+    }
+
+    BL_PROFILE("MLCellLinOp::smoothCorrectionResidual()");
+
+    smoothSweeps(amrlev, mglev, sol, rhs, nsweeps-1, skip_fillboundary);
+    if (nsweeps > 1) skip_fillboundary = false;
+
+    applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution, nullptr, skip_fillboundary);
+    Fsmooth(amrlev, mglev, sol, rhs, 0);
+    applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution);
+
+    // The second color is relaxed one slab at a time, and the residual of
+    // the slab below, whose neighbors are all up to date by then, is
+    // computed while its data are still in cache.
+    const int sdir = AMREX_SPACEDIM-1;
+    const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
+    const auto& maskvals  = m_maskvals [amrlev][mglev];
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(sol, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        const auto& solfab = sol.array(mfi);
+        const auto& rhsfab = rhs.const_array(mfi);
+        const auto& resfab = resid.array(mfi);
+
+        Array<Array4<Real const>,2*AMREX_SPACEDIM> f;
+        Array<Array4<int const>,2*AMREX_SPACEDIM> m;
+        for (OrientationIter oitr; oitr; ++oitr) {
+            f[oitr()] = undrrelxr[oitr()].array(mfi);
+            m[oitr()] = maskvals[oitr()].array(mfi);
+        }
+
+        // The cells next to the box boundaries are done after the ghost
+        // cells are updated.
+        const Box& ibx = amrex::grow(vbx, -1);
+        Box slab = vbx;
+        for (int s = vbx.smallEnd(sdir); s <= vbx.bigEnd(sdir); ++s)
+        {
+            slab.setRange(sdir, s);
+            FsmoothBox(amrlev, mglev, mfi, slab, vbx, solfab, rhsfab, f, m, 1);
+            const Box& rbx = amrex::shift(slab, sdir, -1) & ibx;
+            if (rbx.ok()) {
+                FresidualBox(amrlev, mglev, mfi, rbx, resfab, solfab, rhsfab);
+            }
+        }
+    }
+
+    applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Correction);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(sol, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        const auto& solfab = sol.const_array(mfi);
+        const auto& rhsfab = rhs.const_array(mfi);
+        const auto& resfab = resid.array(mfi);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            Box blo = vbx;
+            blo.setBig(idim, vbx.smallEnd(idim));
+            Box bhi = vbx;
+            bhi.setSmall(idim, vbx.bigEnd(idim));
+            FresidualBox(amrlev, mglev, mfi, blo, resfab, solfab, rhsfab);
+            FresidualBox(amrlev, mglev, mfi, bhi, resfab, solfab, rhsfab);
+        }
+    }
+}
+
+void
+MLCellLinOp::FsmoothBoxSingle (int, int, const MFIter&, const Box&, const Box&,
+                               Array4<float> const&, Array4<float const> const&,
+                               const Array<Array4<Real const>,2*AMREX_SPACEDIM>&,
+                               const Array<Array4<int const>,2*AMREX_SPACEDIM>&,
+                               int) const
+{
+    amrex::Abort("MLCellLinOp::FsmoothBoxSingle: not implemented");
+}
+
+void
+MLCellLinOp::FresidualBoxSingle (int, int, const MFIter&, const Box&, Array4<float> const&,
+                                 Array4<float const> const&, Array4<float const> const&) const
+{
+    amrex::Abort("MLCellLinOp::FresidualBoxSingle: not implemented");
+}
+
+void
+MLCellLinOp::Fdiagonal (int, int, MultiFab&) const
+{
+    amrex::Abort("MLCellLinOp::Fdiagonal: not implemented");
+}
+
+void
+MLCellLinOp::resetChebyshevSmooth () const
+{
+    for (auto& v : m_cheby) {
+        for (auto& p : v) {
+            if (p) p->ready = false;
+        }
+    }
+}
+
+MLCellLinOp::ChebyshevData*
+MLCellLinOp::getChebyshevData (int amrlev, int mglev) const
+{
+    if (info.chebyshev_degree <= 0 || !supportsFdiagonal(amrlev, mglev)) return nullptr;
+
+    if (m_cheby.empty()) {
+        m_cheby.resize(m_num_amr_levels);
+        for (int alev = 0; alev < m_num_amr_levels; ++alev) {
+            m_cheby[alev].resize(m_num_mg_levels[alev]);
+        }
+    }
+
+    std::unique_ptr<ChebyshevData>& cd = m_cheby[amrlev][mglev];
+    if (cd && cd->ready) return cd.get();
+
+    BL_PROFILE("MLCellLinOp::getChebyshevData()");
+
+    const int ncomp = getNComp();
+    if (cd == nullptr) {
+        cd.reset(new ChebyshevData);
+        const BoxArray& ba = m_grids[amrlev][mglev];
+        const DistributionMapping& dm = m_dmap[amrlev][mglev];
+        cd->diaginv.define(ba, dm, ncomp, 0);
+        cd->res.define(ba, dm, ncomp, 0);
+        cd->dir.define(ba, dm, ncomp, 0);
+    }
+
+    MultiFab& diaginv = cd->diaginv;
+    Fdiagonal(amrlev, mglev, diaginv);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(diaginv, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& d = diaginv.array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            d(i,j,k,n) = (d(i,j,k,n) != 0.0) ? 1.0/d(i,j,k,n) : 0.0;
+        });
+    }
+
+    // Estimate the largest eigenvalue of D^{-1}L by power iteration,
+    // starting from a pseudo-random vector.
+    MultiFab v(m_grids[amrlev][mglev], m_dmap[amrlev][mglev], ncomp, 1);
+    MultiFab& w = cd->res;
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(v, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& a = v.array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            unsigned int h = static_cast<unsigned int>(i)*73856093u
+                ^ static_cast<unsigned int>(j)*19349663u
+                ^ static_cast<unsigned int>(k)*83492791u
+                ^ static_cast<unsigned int>(n)*2654435761u;
+            h ^= h >> 13;
+            h *= 0x5bd1e995u;
+            h ^= h >> 15;
+            a(i,j,k,n) = static_cast<Real>(h & 0xffffu)/Real(65535.) - 0.5;
+        });
+    }
+
+    const int niters = 10;
+    Real lambda = 0.0;
+    Real vnorm = std::sqrt(MultiFab::Dot(v, 0, v, 0, ncomp, 0));
+    for (int iter = 0; iter < niters && vnorm > 0.0; ++iter)
+    {
+        v.mult(1.0/vnorm, 0, ncomp, 0);
+        applyBC(amrlev, mglev, v, BCMode::Homogeneous, StateMode::Solution);
+        Fapply(amrlev, mglev, w, v);
+        MultiFab::Multiply(w, diaginv, 0, 0, ncomp, 0);
+        vnorm = std::sqrt(MultiFab::Dot(w, 0, w, 0, ncomp, 0));
+        lambda = vnorm;
+        MultiFab::Copy(v, w, 0, 0, ncomp, 0);
+    }
+
+    // Power iteration underestimates the largest eigenvalue.  The
+    // polynomial damps the upper part of the spectrum, where the errors
+    // the coarse grid cannot correct are.
+    cd->lmax = 1.1*lambda;
+    cd->lmin = 0.1*lambda;
+    cd->ready = true;
+
+    return cd.get();
+}
+
+void
+MLCellLinOp::chebyshevSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                              int degree, bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::chebyshevSmooth()");
+
+    ChebyshevData* cd = getChebyshevData(amrlev, mglev);
+    AMREX_ASSERT(cd != nullptr);
+    if (cd->lmax <= 0.0) return;
+
+    const int ncomp = getNComp();
+    const Real theta = 0.5*(cd->lmax + cd->lmin);
+    const Real delta = 0.5*(cd->lmax - cd->lmin);
+    const Real sigma = theta/delta;
+    Real rho = 1.0/sigma;
+
+    MultiFab& res = cd->res;
+    MultiFab& dir = cd->dir;
+    const MultiFab& diaginv = cd->diaginv;
+
+    // x_{k+1} = x_k + d_k, with d_0 = D^{-1} r_0 / theta and
+    // d_k = rho_k rho_{k-1} d_{k-1} + 2 rho_k / delta D^{-1} r_k.
+    for (int istep = 0; istep < degree; ++istep)
+    {
+        Real c1 = 0.0;
+        Real c2 = 1.0/theta;
+        if (istep > 0) {
+            const Real rho_new = 1.0/(2.0*sigma - rho);
+            c1 = rho_new*rho;
+            c2 = 2.0*rho_new/delta;
+            rho = rho_new;
+        }
+
+        applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
+                nullptr, skip_fillboundary);
+        skip_fillboundary = false;
+        Fapply(amrlev, mglev, res, sol);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(sol, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& x = sol.array(mfi);
+            const auto& b = rhs.const_array(mfi);
+            const auto& r = res.const_array(mfi);
+            const auto& d = dir.array(mfi);
+            const auto& dinv = diaginv.const_array(mfi);
+            if (istep == 0) {
+                AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+                {
+                    d(i,j,k,n) = c2*dinv(i,j,k,n)*(b(i,j,k,n)-r(i,j,k,n));
+                    x(i,j,k,n) += d(i,j,k,n);
+                });
+            } else {
+                AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+                {
+                    d(i,j,k,n) = c1*d(i,j,k,n) + c2*dinv(i,j,k,n)*(b(i,j,k,n)-r(i,j,k,n));
+                    x(i,j,k,n) += d(i,j,k,n);
+                });
+            }
+        }
+    }
+}
+
+void
+MLCellLinOp::applyBCSingle (int amrlev, int mglev, fMultiFab& in, bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::applyBCSingle()");
+
+    const int ncomp = getNComp();
+    if (!skip_fillboundary) {
+        in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(), true);
+    }
+
+    const int imaxorder = maxorder;
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+
+    const auto& maskvals = m_maskvals[amrlev][mglev];
+    const auto& bcondloc = *m_bcondloc[amrlev][mglev];
+
+    FArrayBox foofab(Box::TheUnitBox(),ncomp);
+    const auto& foo = foofab.const_array();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(in, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        const auto& iofab = in.array(mfi);
+
+        const auto & bdlv = bcondloc.bndryLocs(mfi);
+        const auto & bdcv = bcondloc.bndryConds(mfi);
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Orientation olo(idim,Orientation::low);
+            const Orientation ohi(idim,Orientation::high);
+            const Box blo = amrex::adjCellLo(vbx, idim);
+            const Box bhi = amrex::adjCellHi(vbx, idim);
+            const int blen = vbx.length(idim);
+            const auto& mlo = maskvals[olo].array(mfi);
+            const auto& mhi = maskvals[ohi].array(mfi);
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                if (idim == 0) {
+                    mllinop_apply_bc_x(0, blo, blen, iofab, mlo, bdcv[icomp][olo], bdlv[icomp][olo],
+                                       foo, imaxorder, dxinv[0], 0, icomp);
+                    mllinop_apply_bc_x(1, bhi, blen, iofab, mhi, bdcv[icomp][ohi], bdlv[icomp][ohi],
+                                       foo, imaxorder, dxinv[0], 0, icomp);
+                }
+#if (AMREX_SPACEDIM > 1)
+                else if (idim == 1) {
+                    mllinop_apply_bc_y(0, blo, blen, iofab, mlo, bdcv[icomp][olo], bdlv[icomp][olo],
+                                       foo, imaxorder, dxinv[1], 0, icomp);
+                    mllinop_apply_bc_y(1, bhi, blen, iofab, mhi, bdcv[icomp][ohi], bdlv[icomp][ohi],
+                                       foo, imaxorder, dxinv[1], 0, icomp);
+                }
+#if (AMREX_SPACEDIM > 2)
+                else {
+                    mllinop_apply_bc_z(0, blo, blen, iofab, mlo, bdcv[icomp][olo], bdlv[icomp][olo],
+                                       foo, imaxorder, dxinv[2], 0, icomp);
+                    mllinop_apply_bc_z(1, bhi, blen, iofab, mhi, bdcv[icomp][ohi], bdlv[icomp][ohi],
+                                       foo, imaxorder, dxinv[2], 0, icomp);
+                }
+#endif
+#endif
+            }
+        }
+    }
+}
+
+void
+MLCellLinOp::smoothSingle (int amrlev, int mglev, fMultiFab& sol, const fMultiFab& rhs,
+                           int nsweeps, bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::smoothSingle()");
+
+    const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
+    const auto& maskvals  = m_maskvals [amrlev][mglev];
+
+    for (int isweep = 0; isweep < nsweeps; ++isweep)
+    {
+        for (int redblack = 0; redblack < 2; ++redblack)
+        {
+            applyBCSingle(amrlev, mglev, sol, skip_fillboundary);
+            skip_fillboundary = false;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            for (MFIter mfi(sol, MFItInfo().EnableTiling().SetDynamic(true)); mfi.isValid(); ++mfi)
+            {
+                Array<Array4<Real const>,2*AMREX_SPACEDIM> f;
+                Array<Array4<int const>,2*AMREX_SPACEDIM> m;
+                for (OrientationIter oitr; oitr; ++oitr) {
+                    f[oitr()] = undrrelxr[oitr()].array(mfi);
+                    m[oitr()] = maskvals[oitr()].array(mfi);
+                }
+                FsmoothBoxSingle(amrlev, mglev, mfi, mfi.tilebox(), mfi.validbox(),
+                                 sol.array(mfi), rhs.const_array(mfi), f, m, redblack);
+            }
+        }
+    }
+}
+
+void
+MLCellLinOp::correctionResidualSingle (int amrlev, int mglev, fMultiFab& resid, fMultiFab& x,
+                                       const fMultiFab& b) const
+{
+    BL_PROFILE("MLCellLinOp::correctionResidualSingle()");
+
+    applyBCSingle(amrlev, mglev, x);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(resid, MFItInfo().EnableTiling().SetDynamic(true)); mfi.isValid(); ++mfi)
+    {
+        FresidualBoxSingle(amrlev, mglev, mfi, mfi.tilebox(), resid.array(mfi),
+                           x.const_array(mfi), b.const_array(mfi));
+    }
+}
+
+void
+MLCellLinOp::restrictionSingle (int amrlev, int cmglev, fMultiFab& crse, const fMultiFab& fine) const
+{
+    BL_PROFILE("MLCellLinOp::restrictionSingle()");
+
+    const int ncomp = getNComp();
+    const IntVect ratio = (amrlev > 0) ? IntVect(2) : mg_coarsen_ratio_vec[cmglev-1];
+
+    // With agglomeration the coarse grids are not the coarsened fine grids.
+    fMultiFab cfine;
+    fMultiFab* cmf = &crse;
+    if (!amrex::isMFIterSafe(crse, fine)) {
+        cfine.define(amrex::coarsen(fine.boxArray(), ratio), fine.DistributionMap(), ncomp, 0);
+        cmf = &cfine;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(*cmf, true); mfi.isValid(); ++mfi)
+    {
+        amrex_avgdown(mfi.tilebox(), cmf->array(mfi), fine.const_array(mfi), 0, 0, ncomp, ratio);
+    }
+
+    if (cmf != &crse) {
+        crse.ParallelCopy(cfine);
+    }
+}
+
+void
+MLCellLinOp::interpolationSingle (int amrlev, int fmglev, fMultiFab& fine, const fMultiFab& crse) const
+{
+    BL_PROFILE("MLCellLinOp::interpolationSingle()");
+
+    const int ncomp = getNComp();
+
+    Dim3 ratio3 = {2,2,2};
+    IntVect ratio = (amrlev > 0) ? IntVect(2) : mg_coarsen_ratio_vec[fmglev];
+    AMREX_D_TERM(ratio3.x = ratio[0];,
+                 ratio3.y = ratio[1];,
+                 ratio3.z = ratio[2];);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(fine, true); mfi.isValid(); ++mfi)
+    {
+        const auto& cfab = crse.const_array(mfi);
+        const auto& ffab = fine.array(mfi);
+        amrex::LoopConcurrentOnCpu(mfi.tilebox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            int ic = amrex::coarsen(i,ratio3.x);
+            int jc = amrex::coarsen(j,ratio3.y);
+            int kc = amrex::coarsen(k,ratio3.z);
+            ffab(i,j,k,n) += cfab(ic,jc,kc,n);
+        });
+    }
+}
+
 void
 MLCellLinOp::updateSolBC (int amrlev, const MultiFab& crse_bcdata) const
 {
@@ -750,6 +1429,10 @@ MLCellLinOp::prepareForSolve ()
 {
     BL_PROFILE("MLCellLinOp::prepareForSolve()");
 
+    m_ca_smooth.clear();
+    m_ca_smooth_ok.clear();
+    resetChebyshevSmooth();
+
     const int imaxorder = maxorder;
     const int ncomp = getNComp();
     for (int amrlev = 0;  amrlev < m_num_amr_levels; ++amrlev)
@@ -115,6 +115,7 @@ MLEBABecLap::setScalars (Real a, Real b)
             m_a_coeffs[amrlev][0].setVal(0.0);
         }
     }
+    m_needs_update = true;
 }
 
 void
@@ -0,0 +1,391 @@
+
+#include <cmath>
+#include <limits>
+
+#include <AMReX_MLFFTBottom.H>
+#include <AMReX_LOUtil_K.H>
+#include <AMReX_ParallelReduce.H>
+
+namespace amrex {
+
+namespace {
+
+// Eigenvalues w and eigenvectors v (column k of the row major v is the
+// k-th one) of the symmetric n x n matrix a with the cyclic Jacobi
+// method.  a is destroyed.
+void
+jacobiEigen (int n, Vector<Real>& a, Vector<Real>& w, Vector<Real>& v)
+{
+    v.assign(n*n, 0.0);
+    for (int i = 0; i < n; ++i) v[i*n+i] = 1.0;
+
+    Real anorm = 0.0;
+    for (int i = 0; i < n*n; ++i) anorm += a[i]*a[i];
+
+    for (int sweep = 0; sweep < 100; ++sweep)
+    {
+        Real off = 0.0;
+        for (int p = 0; p < n; ++p) {
+            for (int q = p+1; q < n; ++q) {
+                off += a[p*n+q]*a[p*n+q];
+            }
+        }
+        if (off <= 1.e-30*anorm) break;
+
+        for (int p = 0; p < n; ++p) {
+            for (int q = p+1; q < n; ++q) {
+                const Real apq = a[p*n+q];
+                if (std::abs(apq) <= 1.e-300) continue;
+                const Real theta = (a[q*n+q]-a[p*n+p])/(2.0*apq);
+                const Real t = std::copysign(1.0, theta)
+                    / (std::abs(theta) + std::sqrt(theta*theta+1.0));
+                const Real c = 1.0/std::sqrt(t*t+1.0);
+                const Real s = t*c;
+                for (int k = 0; k < n; ++k) {
+                    const Real akp = a[k*n+p];
+                    const Real akq = a[k*n+q];
+                    a[k*n+p] = c*akp - s*akq;
+                    a[k*n+q] = s*akp + c*akq;
+                }
+                for (int k = 0; k < n; ++k) {
+                    const Real apk = a[p*n+k];
+                    const Real aqk = a[q*n+k];
+                    a[p*n+k] = c*apk - s*aqk;
+                    a[q*n+k] = s*apk + c*aqk;
+                }
+                for (int k = 0; k < n; ++k) {
+                    const Real vkp = v[k*n+p];
+                    const Real vkq = v[k*n+q];
+                    v[k*n+p] = c*vkp - s*vkq;
+                    v[k*n+q] = s*vkp + c*vkq;
+                }
+            }
+        }
+    }
+
+    w.resize(n);
+    for (int i = 0; i < n; ++i) w[i] = a[i*n+i];
+}
+
+// p <- M p along direction idim of the Fortran ordered array p with
+// lengths len.  M is row major.
+void
+transform1D (Real* p, const IntVect& len, int idim, const Vector<Real>& M)
+{
+    const int n = len[idim];
+    Long s = 1;
+    for (int d = 0; d < idim; ++d) s *= len[d];
+    Long nlines = 1;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        if (d != idim) nlines *= len[d];
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<Real> line(n);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (Long iline = 0; iline < nlines; ++iline)
+        {
+            const Long blk = iline / s;
+            const Long r = iline - blk*s;
+            Real* q = p + blk*s*n + r;
+            for (int m = 0; m < n; ++m) line[m] = q[m*s];
+            for (int k = 0; k < n; ++k) {
+                const Real* Mk = M.data() + k*n;
+                Real sum = 0.0;
+                for (int m = 0; m < n; ++m) sum += Mk[m]*line[m];
+                q[k*s] = sum;
+            }
+        }
+    }
+}
+
+}
+
+MLFFTBottom::MLFFTBottom (const MLLinOp& a_linop)
+    : m_linop(dynamic_cast<const MLCellABecLap&>(a_linop))
+{}
+
+MLFFTBottom::~MLFFTBottom () {}
+
+bool
+MLFFTBottom::isSupported (const MLLinOp& a_linop, std::string* why)
+{
+    auto fail = [why] (const char* msg) -> bool {
+        if (why) *why = msg;
+        return false;
+    };
+
+    const MLCellABecLap* op = dynamic_cast<const MLCellABecLap*>(&a_linop);
+    if (op == nullptr) {
+        return fail("only cell-centered (alpha a - beta div b grad) operators are supported");
+    }
+    if (!op->isCrossStencil() || op->isTensorOp()) {
+        return fail("embedded boundaries and tensor operators are not supported");
+    }
+    if (op->m_has_metric_term) {
+        return fail("metric terms are not supported");
+    }
+
+    const int mglev = op->NMGLevels(0) - 1;
+    if (op->getOversetMask(0, mglev) != nullptr) {
+        return fail("overset masks are not supported");
+    }
+    if (op->m_grids[0][mglev].numPts() != op->m_geom[0][mglev].Domain().numPts()) {
+        return fail("the coarsest level does not cover the domain");
+    }
+    if (op->getMaxOrder() > 3) {
+        return fail("maxorder > 3 is not supported");
+    }
+
+    const int ncomp = op->getNComp();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        for (int icomp = 0; icomp < ncomp; ++icomp) {
+            if (op->m_lobc[icomp][idim] != op->m_lobc[0][idim] ||
+                op->m_hibc[icomp][idim] != op->m_hibc[0][idim]) {
+                return fail("the components have different boundary conditions");
+            }
+        }
+        for (const auto bc : {op->m_lobc[0][idim], op->m_hibc[0][idim]}) {
+            if (bc != LinOpBCType::Periodic && bc != LinOpBCType::Dirichlet &&
+                bc != LinOpBCType::Neumann && bc != LinOpBCType::reflect_odd) {
+                return fail("only periodic, Dirichlet, Neumann and reflect_odd boundaries are supported");
+            }
+        }
+    }
+
+    return true;
+}
+
+Vector<Real>
+MLFFTBottom::build1D (int idim) const
+{
+    const int mglev = m_linop.NMGLevels(0) - 1;
+    const Geometry& geom = m_linop.m_geom[0][mglev];
+    const BoxArray& ba = m_linop.m_grids[0][mglev];
+    const int n = m_domain.length(idim);
+
+    Vector<Real> T(n*n, 0.0);
+
+    if (geom.isPeriodic(idim))
+    {
+        for (int i = 0; i < n; ++i) {
+            T[i*n+i] += 2.0;
+            T[i*n+(i+n-1)%n] -= 1.0;
+            T[i*n+(i+1)%n] -= 1.0;
+        }
+        return T;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        T[i*n+i] = 2.0;
+        if (i > 0) T[i*n+i-1] = -1.0;
+        if (i < n-1) T[i*n+i+1] = -1.0;
+    }
+
+    // Fold the ghost cells into the boundary rows as mllinop_apply_bc_x
+    // etc. do with homogeneous boundary values.
+    const Real dxinv = geom.InvCellSize(idim);
+    for (int side = 0; side < 2; ++side)
+    {
+        const LinOpBCType bct = (side == 0) ? m_linop.m_lobc[0][idim] : m_linop.m_hibc[0][idim];
+        const int ib = (side == 0) ? 0 : n-1;
+        const int s = (side == 0) ? 1 : -1;
+        if (bct == LinOpBCType::Neumann)
+        {
+            T[ib*n+ib] -= 1.0;
+        }
+        else if (bct == LinOpBCType::reflect_odd)
+        {
+            T[ib*n+ib] += 1.0;
+        }
+        else if (bct == LinOpBCType::Dirichlet)
+        {
+            int blen = n;
+            for (int ibox = 0, nbox = ba.size(); ibox < nbox; ++ibox) {
+                const Box& bx = ba[ibox];
+                if (( side == 0 && bx.smallEnd(idim) == m_domain.smallEnd(idim)) ||
+                    ( side == 1 && bx.bigEnd(idim) == m_domain.bigEnd(idim))) {
+                    blen = std::min(blen, bx.length(idim));
+                }
+            }
+            const Real bcl = (side == 0) ? m_linop.m_domain_bloc_lo[idim] : m_linop.m_domain_bloc_hi[idim];
+            const int NX = std::min(blen+1, m_linop.getMaxOrder());
+            Real x[4] = {-bcl*dxinv, Real(0.5), Real(1.5), Real(2.5)};
+            Real coef[4] = {0.0, 0.0, 0.0, 0.0};
+            poly_interp_coeff(-Real(0.5), x, NX, coef);
+            for (int m = 1; m < NX; ++m) {
+                T[ib*n+ib+(m-1)*s] -= coef[m];
+            }
+        }
+    }
+
+    return T;
+}
+
+void
+MLFFTBottom::setup ()
+{
+    BL_PROFILE("MLFFTBottom::setup()");
+
+    const int mglev = m_linop.NMGLevels(0) - 1;
+    const Geometry& geom = m_linop.m_geom[0][mglev];
+    m_domain = geom.Domain();
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        Vector<Real> T = build1D(idim);
+        if (T == m_op1d[idim]) continue;
+
+        const int n = m_domain.length(idim);
+
+        // D^{-1} T D is symmetric for the boundary stencils of maxorder <= 3.
+        Vector<Real> d(n, 1.0);
+        for (int i = 0; i+1 < n; ++i) {
+            const Real up = T[i*n+i+1];
+            const Real lo = T[(i+1)*n+i];
+            d[i+1] = (up*lo > 0.0) ? d[i]*std::sqrt(lo/up) : d[i];
+        }
+        Vector<Real> S(n*n);
+        Real smax = 0.0;
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                S[i*n+j] = T[i*n+j]*d[j]/d[i];
+                smax = std::max(smax, std::abs(S[i*n+j]));
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < i; ++j) {
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(std::abs(S[i*n+j]-S[j*n+i]) <= 1.e-12*smax,
+                                                 "MLFFTBottom: boundary stencil is not symmetrizable");
+            }
+        }
+
+        Vector<Real> Q;
+        jacobiEigen(n, S, m_lambda[idim], Q);
+
+        // T = B diag(lambda) F with B = D Q and F = Q^T D^{-1}
+        m_fwd[idim].resize(n*n);
+        m_bwd[idim].resize(n*n);
+        for (int i = 0; i < n; ++i) {
+            for (int k = 0; k < n; ++k) {
+                m_bwd[idim][i*n+k] = d[i]*Q[i*n+k];
+                m_fwd[idim][k*n+i] = Q[i*n+k]/d[i];
+            }
+        }
+
+        m_op1d[idim] = std::move(T);
+    }
+
+    // The coefficients must be constant.  Their extrema are reduced at once.
+    const Real ascalar = m_linop.getAScalar();
+    const Real bscalar = m_linop.getBScalar();
+    MultiFab const* acoef = m_linop.getACoeffs(0, mglev);
+    const Array<MultiFab const*,AMREX_SPACEDIM> bcoef = m_linop.getBCoeffs(0, mglev);
+
+    // minimum and negative maximum of a and of the b's
+    constexpr int nr = 2*(AMREX_SPACEDIM+1);
+    Real r[nr];
+    for (int i = 0; i < nr; ++i) r[i] = 0.0;
+    if (acoef) {
+        r[0] =  acoef->min(0, 0, true);
+        r[1] = -acoef->max(0, 0, true);
+    }
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (bcoef[idim]) {
+            const MultiFab& bmf = *bcoef[idim];
+            Real bmin = std::numeric_limits<Real>::max();
+            Real bmax = std::numeric_limits<Real>::lowest();
+            for (int icomp = 0; icomp < bmf.nComp(); ++icomp) {
+                bmin = std::min(bmin, bmf.min(icomp, 0, true));
+                bmax = std::max(bmax, bmf.max(icomp, 0, true));
+            }
+            r[2+2*idim] =  bmin;
+            r[3+2*idim] = -bmax;
+        }
+    }
+    ParallelAllReduce::Min(r, nr, ParallelContext::CommunicatorSub());
+
+    auto const_value = [] (Real vmin, Real vmax) -> Real {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(vmax-vmin <= 1.e-10*std::max(std::abs(vmin),std::abs(vmax)),
+                                         "MLFFTBottom: coefficients are not constant on the bottom level");
+        return 0.5*(vmin+vmax);
+    };
+
+    m_diag = (acoef && ascalar != 0.0) ? ascalar*const_value(r[0], -r[1]) : 0.0;
+    const Real* dxinv = geom.InvCellSize();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const Real bval = (bcoef[idim]) ? const_value(r[2+2*idim], -r[3+2*idim]) : 1.0;
+        m_scale[idim] = bscalar*bval*dxinv[idim]*dxinv[idim];
+    }
+
+    m_ready = true;
+}
+
+void
+MLFFTBottom::solve (MultiFab& x, const MultiFab& b)
+{
+    BL_PROFILE("MLFFTBottom::solve()");
+
+    if (!m_ready) setup();
+
+    const int ncomp = m_linop.getNComp();
+
+    // Gather on the owner of the first box.
+    BoxArray gba(m_domain);
+    DistributionMapping gdm(Vector<int>{b.DistributionMap()[0]});
+    MultiFab phi(gba, gdm, ncomp, 0);
+    phi.ParallelCopy(b, 0, 0, ncomp);
+
+    for (MFIter mfi(phi); mfi.isValid(); ++mfi)
+    {
+        const IntVect len = m_domain.length();
+        const Long npts = m_domain.numPts();
+
+        Real dmax = std::abs(m_diag);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            Real lmax = 0.0;
+            for (const Real l : m_lambda[idim]) lmax = std::max(lmax, std::abs(l));
+            dmax += std::abs(m_scale[idim])*lmax;
+        }
+        const Real eps = 1.e-12*dmax;
+
+        for (int icomp = 0; icomp < ncomp; ++icomp)
+        {
+            Real* p = phi[mfi].dataPtr(icomp);
+
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                transform1D(p, len, idim, m_fwd[idim]);
+            }
+
+            // The zero mode of a singular problem has been removed from
+            // the right-hand side by MLMG, and is set to zero here.
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (Long ipt = 0; ipt < npts; ++ipt)
+            {
+                Long rem = ipt;
+                Real denom = m_diag;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    const int kd = static_cast<int>(rem % len[idim]);
+                    rem /= len[idim];
+                    denom += m_scale[idim]*m_lambda[idim][kd];
+                }
+                p[ipt] = (std::abs(denom) > eps) ? p[ipt]/denom : 0.0;
+            }
+
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                transform1D(p, len, idim, m_bwd[idim]);
+            }
+        }
+    }
+
+    x.ParallelCopy(phi, 0, 0, ncomp);
+}
+
+}
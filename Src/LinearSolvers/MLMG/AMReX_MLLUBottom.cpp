@@ -0,0 +1,434 @@
+
+#include <algorithm>
+#include <cmath>
+
+#include <AMReX_MLLUBottom.H>
+#include <AMReX_MLCellABecLap.H>
+
+namespace amrex {
+
+MLLUBottom::MLLUBottom (const MLLinOp& a_linop)
+    : m_linop(dynamic_cast<const MLCellLinOp&>(a_linop))
+{}
+
+MLLUBottom::~MLLUBottom () {}
+
+bool
+MLLUBottom::isSupported (const MLLinOp& a_linop, std::string* why)
+{
+    auto fail = [why] (const char* msg) -> bool {
+        if (why) *why = msg;
+        return false;
+    };
+
+    const MLCellLinOp* op = dynamic_cast<const MLCellLinOp*>(&a_linop);
+    if (op == nullptr) {
+        return fail("only cell-centered operators are supported");
+    }
+    if (op->getMaxOrder() > 3) {
+        return fail("maxorder > 3 is not supported");
+    }
+    const MLCellABecLap* abec = dynamic_cast<const MLCellABecLap*>(op);
+    if (abec && abec->getOversetMask(0, abec->NMGLevels(0)-1) != nullptr) {
+        return fail("overset masks are not supported");
+    }
+    return true;
+}
+
+void
+MLLUBottom::setup (const MultiFab& x)
+{
+    BL_PROFILE("MLLUBottom::setup()");
+
+    const int mglev = m_linop.NMGLevels(0) - 1;
+    const Geometry& geom = m_linop.m_geom[0][mglev];
+    const int ncomp = m_linop.getNComp();
+
+    m_domain = geom.Domain();
+    m_root = x.DistributionMap()[0];
+    const IntVect len = m_domain.length();
+    const IntVect dlo = m_domain.smallEnd();
+    const Long npts = m_domain.numPts();
+
+    BoxArray gba(m_domain);
+    DistributionMapping gdm(Vector<int>{m_root});
+
+    MultiFab gvalid(gba, gdm, 1, 0);
+    {
+        MultiFab ones(x.boxArray(), x.DistributionMap(), 1, 0);
+        ones.setVal(1.0);
+        gvalid.setVal(0.0);
+        gvalid.ParallelCopy(ones);
+    }
+    bool is_root = false;
+    for (MFIter mfi(gvalid); mfi.isValid(); ++mfi) is_root = true;
+
+    // Cells closer than three cells in every direction have different
+    // colors.  In a periodic direction, the number of colors must
+    // divide the number of cells.
+    IntVect ncolors;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int n = len[idim];
+        int m = std::min(3, n);
+        if (geom.isPeriodic(idim) && n > 3 && n%3 != 0) {
+            m = 4;
+            while (n%m != 0) ++m;
+        }
+        ncolors[idim] = m;
+    }
+
+    // Cells are ordered with the longest direction varying the slowest.
+    // Periodic directions are folded, 0, n-1, 1, n-2, ..., so that the
+    // cells across the periodic boundary are close in the ordering.
+    if (is_root) {
+        Real const* pvalid = nullptr;
+        for (MFIter mfi(gvalid); mfi.isValid(); ++mfi) {
+            pvalid = gvalid[mfi].dataPtr();
+        }
+
+        int perm[AMREX_SPACEDIM];
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) perm[idim] = idim;
+        std::stable_sort(perm, perm+AMREX_SPACEDIM,
+                         [&len] (int a, int b) { return len[a] < len[b]; });
+
+        Vector<Long> cell_of_key(npts);
+        for (Long icell = 0; icell < npts; ++icell) {
+            Long rem = icell;
+            IntVect iv;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                iv[idim] = static_cast<int>(rem % len[idim]);
+                rem /= len[idim];
+                if (geom.isPeriodic(idim)) {
+                    const int n = len[idim];
+                    iv[idim] = (iv[idim] < (n+1)/2) ? 2*iv[idim] : 2*(n-1-iv[idim])+1;
+                }
+            }
+            Long key = 0;
+            for (int d = AMREX_SPACEDIM-1; d >= 0; --d) {
+                key = key*len[perm[d]] + iv[perm[d]];
+            }
+            cell_of_key[key] = icell;
+        }
+
+        m_index.assign(npts, -1);
+        Long nvalid = 0;
+        for (Long key = 0; key < npts; ++key) {
+            const Long icell = cell_of_key[key];
+            if (pvalid[icell] != 0.0) m_index[icell] = nvalid++;
+        }
+        m_n = nvalid*ncomp;
+    }
+
+    // Apply the operator to each color and component, and collect the
+    // entries on the root.
+    Vector<Long> rows, cols;
+    Vector<Real> vals;
+
+    MultiFab in(x.boxArray(), x.DistributionMap(), ncomp, x.nGrow(), MFInfo(), x.Factory());
+    MultiFab out(x.boxArray(), x.DistributionMap(), ncomp, 0, MFInfo(), x.Factory());
+    MultiFab gout(gba, gdm, ncomp, 0);
+
+    const int ntotcolors = AMREX_D_TERM(ncolors[0],*ncolors[1],*ncolors[2]);
+    for (int icolor = 0; icolor < ntotcolors; ++icolor)
+    {
+        IntVect color;
+        {
+            int rem = icolor;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                color[idim] = rem % ncolors[idim];
+                rem /= ncolors[idim];
+            }
+        }
+        const IntVect nc = ncolors;
+        const IntVect c = color;
+        const IntVect lo = dlo;
+
+        for (int icomp = 0; icomp < ncomp; ++icomp)
+        {
+            in.setVal(0.0);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for (MFIter mfi(in, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                const auto& a = in.array(mfi);
+                AMREX_HOST_DEVICE_PARALLEL_FOR_3D ( bx, i, j, k,
+                {
+                    IntVect iv(AMREX_D_DECL(i,j,k));
+                    bool same = true;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        same = same && ((iv[idim]-lo[idim]) % nc[idim] == c[idim]);
+                    }
+                    if (same) a(i,j,k,icomp) = 1.0;
+                    amrex::ignore_unused(k);
+                });
+            }
+
+            m_linop.apply(0, mglev, out, in, MLLinOp::BCMode::Homogeneous,
+                          MLLinOp::StateMode::Correction);
+
+            gout.ParallelCopy(out, 0, 0, ncomp);
+
+            if (!is_root) continue;
+
+            for (MFIter mfi(gout); mfi.isValid(); ++mfi)
+            {
+                for (Long icell = 0; icell < npts; ++icell)
+                {
+                    if (m_index[icell] < 0) continue;
+                    Long rem = icell;
+                    IntVect iv;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        iv[idim] = static_cast<int>(rem % len[idim]);
+                        rem /= len[idim];
+                    }
+
+                    // The only cell of this color that the row can involve
+                    Long jcell = -1;
+                    for (int ioff = 0; ioff < AMREX_D_TERM(3,*3,*3) && jcell < 0; ++ioff)
+                    {
+                        int r = ioff;
+                        IntVect jv;
+                        bool ok = true;
+                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                            jv[idim] = iv[idim] + (r%3) - 1;
+                            r /= 3;
+                            if (geom.isPeriodic(idim)) {
+                                jv[idim] = (jv[idim] + len[idim]) % len[idim];
+                            } else if (jv[idim] < 0 || jv[idim] >= len[idim]) {
+                                ok = false;
+                            }
+                            ok = ok && (jv[idim] % ncolors[idim] == color[idim]);
+                        }
+                        if (!ok) continue;
+                        Long jc = 0;
+                        for (int idim = AMREX_SPACEDIM-1; idim >= 0; --idim) {
+                            jc = jc*len[idim] + jv[idim];
+                        }
+                        if (m_index[jc] >= 0) jcell = jc;
+                    }
+
+                    for (int irow = 0; irow < ncomp; ++irow)
+                    {
+                        const Real v = gout[mfi].dataPtr(irow)[icell];
+                        if (v == 0.0) continue;
+                        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(jcell >= 0,
+                            "MLLUBottom: the stencil extends beyond one cell");
+                        rows.push_back(m_index[icell]*ncomp + irow);
+                        cols.push_back(m_index[jcell]*ncomp + icomp);
+                        vals.push_back(v);
+                    }
+                }
+            }
+        }
+    }
+
+    if (is_root)
+    {
+        // Rows without entries, e.g., of covered cells, are replaced by
+        // x = 0.  For a singular problem, the first other unknown of each
+        // component is set to zero too.  The right-hand side has been
+        // made solvable.
+        m_empty.assign(m_n, 1);
+        for (Long ientry = 0, nentries = rows.size(); ientry < nentries; ++ientry) {
+            m_empty[rows[ientry]] = 0;
+        }
+        m_pinned.clear();
+        for (Long i = 0; i < m_n; ++i) {
+            if (m_empty[i]) m_pinned.push_back(i);
+        }
+        if (m_linop.isBottomSingular()) {
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                Long i = icomp;
+                while (i < m_n && m_empty[i]) i += ncomp;
+                if (i >= m_n) continue;
+                m_pinned.push_back(i);
+                for (Long ientry = 0, nentries = rows.size(); ientry < nentries; ++ientry) {
+                    if (rows[ientry] == i) vals[ientry] = 0.0;
+                }
+            }
+        }
+        for (const Long i : m_pinned) {
+            rows.push_back(i);
+            cols.push_back(i);
+            vals.push_back(1.0);
+        }
+
+        Long kl = 0, ku = 0;
+        for (Long ientry = 0, nentries = rows.size(); ientry < nentries; ++ientry) {
+            if (vals[ientry] == 0.0) continue;
+            kl = std::max(kl, rows[ientry]-cols[ientry]);
+            ku = std::max(ku, cols[ientry]-rows[ientry]);
+        }
+        m_kl = static_cast<int>(kl);
+        m_ku = static_cast<int>(ku);
+
+        const Long width = 2*m_kl + m_ku + 1;
+        if (static_cast<double>(m_n)*static_cast<double>(width) > 2.e8) {
+            amrex::Abort("MLLUBottom: the bottom problem is too large for a direct solve."
+                         " Allow more coarsening.");
+        }
+        m_band.assign(m_n*width, 0.0);
+        for (Long ientry = 0, nentries = rows.size(); ientry < nentries; ++ientry) {
+            const Long i = rows[ientry];
+            m_band[i*width + cols[ientry]-i+m_kl] += vals[ientry];
+        }
+
+        m_rows = std::move(rows);
+        m_cols = std::move(cols);
+        m_vals = std::move(vals);
+
+        factor();
+    }
+
+    m_ready = true;
+}
+
+void
+MLLUBottom::factor ()
+{
+    BL_PROFILE("MLLUBottom::factor()");
+
+    // Gaussian elimination with partial pivoting as in LAPACK's dgbtf2.
+    // The multipliers are not swapped by later pivots, so they are
+    // applied to the right-hand side step by step in the same order.
+    const Long n = m_n;
+    const int kl = m_kl;
+    const int kuf = m_ku + m_kl;
+    const Long width = 2*m_kl + m_ku + 1;
+    auto A = [&] (Long i, Long j) -> Real& { return m_band[i*width + j-i+kl]; };
+
+    m_lower.assign(n*std::max(kl,1), 0.0);
+    m_pivot.resize(n);
+
+    for (Long k = 0; k < n; ++k)
+    {
+        const Long iend = std::min(n-1, k+kl);
+        const Long jend = std::min(n-1, k+kuf);
+
+        Long p = k;
+        Real pmax = std::abs(A(k,k));
+        for (Long i = k+1; i <= iend; ++i) {
+            if (std::abs(A(i,k)) > pmax) {
+                pmax = std::abs(A(i,k));
+                p = i;
+            }
+        }
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(pmax > 0.0, "MLLUBottom: the bottom matrix is singular");
+        m_pivot[k] = p;
+        if (p != k) {
+            for (Long j = k; j <= jend; ++j) std::swap(A(k,j), A(p,j));
+        }
+
+        const Real pivinv = 1.0/A(k,k);
+        Real const* AMREX_RESTRICT rowk = &A(k,k);
+        for (Long i = k+1; i <= iend; ++i) {
+            const Real l = A(i,k)*pivinv;
+            m_lower[k*kl + (i-k-1)] = l;
+            A(i,k) = 0.0;
+            if (l == 0.0) continue;
+            Real* AMREX_RESTRICT rowi = &A(i,k);
+            for (Long j = 1; j <= jend-k; ++j) {
+                rowi[j] -= l*rowk[j];
+            }
+        }
+    }
+}
+
+void
+MLLUBottom::substitute (Vector<Real>& r) const
+{
+    const Long n = m_n;
+    const int kl = m_kl;
+    const int kuf = m_ku + m_kl;
+    const Long width = 2*m_kl + m_ku + 1;
+
+    for (Long k = 0; k < n; ++k) {
+        std::swap(r[k], r[m_pivot[k]]);
+        const Long iend = std::min(n-1, k+kl);
+        for (Long i = k+1; i <= iend; ++i) {
+            r[i] -= m_lower[k*kl + (i-k-1)] * r[k];
+        }
+    }
+
+    for (Long k = n-1; k >= 0; --k) {
+        Real const* AMREX_RESTRICT rowk = m_band.data() + k*width + kl;
+        const Long jend = std::min(n-1, k+kuf);
+        Real s = r[k];
+        for (Long j = k+1; j <= jend; ++j) {
+            s -= rowk[j-k]*r[j];
+        }
+        r[k] = s/rowk[0];
+    }
+}
+
+void
+MLLUBottom::solve (MultiFab& x, const MultiFab& b)
+{
+    BL_PROFILE("MLLUBottom::solve()");
+
+    if (!m_ready) setup(x);
+
+    const int ncomp = m_linop.getNComp();
+
+    BoxArray gba(m_domain);
+    DistributionMapping gdm(Vector<int>{m_root});
+    MultiFab phi(gba, gdm, ncomp, 0);
+    phi.ParallelCopy(b, 0, 0, ncomp);
+
+    for (MFIter mfi(phi); mfi.isValid(); ++mfi)
+    {
+        const Long npts = m_domain.numPts();
+        const Long n = m_n;
+
+        Vector<Real> r(n);
+        for (Long icell = 0; icell < npts; ++icell) {
+            if (m_index[icell] < 0) continue;
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                r[m_index[icell]*ncomp+icomp] = phi[mfi].dataPtr(icomp)[icell];
+            }
+        }
+        for (const Long i : m_pinned) r[i] = 0.0;
+
+        // One step of iterative refinement recovers the accuracy lost to
+        // the conditioning of the matrix, e.g., of a singular problem with
+        // one unknown set to zero.
+        Vector<Real> res(r);
+        substitute(r);
+        for (Long ientry = 0, nentries = m_rows.size(); ientry < nentries; ++ientry) {
+            res[m_rows[ientry]] -= m_vals[ientry] * r[m_cols[ientry]];
+        }
+        substitute(res);
+        for (Long i = 0; i < n; ++i) {
+            r[i] += res[i];
+        }
+
+        // Like the Krylov solvers, return the solution of a singular
+        // problem with zero mean.
+        if (m_linop.isBottomSingular()) {
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                Real sum = 0.0;
+                Long cnt = 0;
+                for (Long i = icomp; i < n; i += ncomp) {
+                    if (!m_empty[i]) { sum += r[i]; ++cnt; }
+                }
+                const Real avg = (cnt > 0) ? sum/cnt : 0.0;
+                for (Long i = icomp; i < n; i += ncomp) {
+                    if (!m_empty[i]) r[i] -= avg;
+                }
+            }
+        }
+
+        for (Long icell = 0; icell < npts; ++icell) {
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                phi[mfi].dataPtr(icomp)[icell] = (m_index[icell] < 0)
+                    ? 0.0 : r[m_index[icell]*ncomp+icomp];
+            }
+        }
+    }
+
+    x.ParallelCopy(phi, 0, 0, ncomp);
+}
+
+}
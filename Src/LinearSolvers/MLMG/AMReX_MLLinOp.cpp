@@ -738,6 +738,48 @@ MLLinOp::setCoarseFineBC (const MultiFab* crse, int crse_ratio) noexcept
     m_coarse_data_crse_ratio = crse_ratio;
 }
 
+void
+MLLinOp::smoothSweeps (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                       int nsweeps, bool skip_fillboundary) const
+{
+    for (int i = 0; i < nsweeps; ++i) {
+        smooth(amrlev, mglev, sol, rhs, skip_fillboundary);
+        skip_fillboundary = false;
+    }
+}
+
+void
+MLLinOp::smoothCorrectionResidual (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                                   MultiFab& resid, int nsweeps, bool skip_fillboundary)
+{
+    smoothSweeps(amrlev, mglev, sol, rhs, nsweeps, skip_fillboundary);
+    correctionResidual(amrlev, mglev, resid, sol, rhs, BCMode::Homogeneous);
+}
+
+void
+MLLinOp::smoothSingle (int, int, fMultiFab&, const fMultiFab&, int, bool) const
+{
+    amrex::Abort("MLLinOp::smoothSingle: not implemented");
+}
+
+void
+MLLinOp::correctionResidualSingle (int, int, fMultiFab&, fMultiFab&, const fMultiFab&) const
+{
+    amrex::Abort("MLLinOp::correctionResidualSingle: not implemented");
+}
+
+void
+MLLinOp::restrictionSingle (int, int, fMultiFab&, const fMultiFab&) const
+{
+    amrex::Abort("MLLinOp::restrictionSingle: not implemented");
+}
+
+void
+MLLinOp::interpolationSingle (int, int, fMultiFab&, const fMultiFab&) const
+{
+    amrex::Abort("MLLinOp::interpolationSingle: not implemented");
+}
+
 MPI_Comm
 MLLinOp::makeSubCommunicator (const DistributionMapping& dm)
 {
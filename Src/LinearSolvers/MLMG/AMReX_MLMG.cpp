@@ -36,6 +36,12 @@
 //                           For Inhomogeneous, BC data can be optionally provided.
 //     reflux()            : Given sol on crse and fine AMR levels, reflux coarse res at crse/fine.
 //     smooth()            : L(cor) = res. cor.FillBoundary() will be called.
+//     smoothCorrectionResidual(): smooth() followed by correctionResidual(), which
+//                           some operators fuse.
+
+// Mixed precision: with setMixedPrecision, the MG levels below the finest of
+// the coarsest AMR level use the float copies fres, fcor and frescor of res,
+// cor and rescor (see mgVcycleSingle).
 
 namespace amrex {
 
@@ -62,7 +68,8 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         bottom_solver = linop.getDefaultBottomSolver();
     }
 
-    if (bottom_solver == BottomSolver::hypre || bottom_solver == BottomSolver::petsc) {
+    if (bottom_solver == BottomSolver::hypre || bottom_solver == BottomSolver::petsc ||
+        bottom_solver == BottomSolver::lu) {
         int mo = linop.getMaxOrder();
         if (a_sol[0]->hasEBFabFactory()) {
             linop.setMaxOrder(2);
@@ -70,6 +77,11 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
             linop.setMaxOrder(std::min(3,mo));  // maxorder = 4 not supported
         }
     }
+
+    if (bottom_solver == BottomSolver::fft) {
+        // The boundary stencil must only involve two interior cells.
+        linop.setMaxOrder(std::min(3,linop.getMaxOrder()));
+    }
     
     bool is_nsolve = linop.m_parent;
 
@@ -86,35 +98,64 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
     int ncomp = linop.getNComp();
 
+    // With independent components, e.g., several right-hand sides solved
+    // together, each component has its own norms and tolerance.
     bool local = true;
-    Real resnorm0 = MLResNormInf(finest_amr_lev, local); 
-    Real rhsnorm0 = MLRhsNormInf(local); 
+    Vector<Real> resnorm0 = MLResNormInfComps(finest_amr_lev, local);
+    Vector<Real> rhsnorm0 = MLRhsNormInfComps(local);
+    const int ncol = resnorm0.size();
     if (!is_nsolve) {
-        ParallelAllReduce::Max<Real>({resnorm0, rhsnorm0}, ParallelContext::CommunicatorSub());
+        Vector<Real> tmp = resnorm0;
+        tmp.insert(tmp.end(), rhsnorm0.begin(), rhsnorm0.end());
+        ParallelAllReduce::Max(tmp.data(), 2*ncol, ParallelContext::CommunicatorSub());
+        std::copy(tmp.begin(), tmp.begin()+ncol, resnorm0.begin());
+        std::copy(tmp.begin()+ncol, tmp.end(), rhsnorm0.begin());
+    }
 
-        if (verbose >= 1)
-        {
-            amrex::Print() << "MLMG: Initial rhs               = " << rhsnorm0 << "\n"
-                           << "MLMG: Initial residual (resid0) = " << resnorm0 << "\n";
-        }
+    auto max_of = [] (Vector<Real> const& v) -> Real {
+        return *std::max_element(v.begin(), v.end());
+    };
+
+    if (!is_nsolve && verbose >= 1)
+    {
+        amrex::Print() << "MLMG: Initial rhs               = " << max_of(rhsnorm0) << "\n"
+                       << "MLMG: Initial residual (resid0) = " << max_of(resnorm0) << "\n";
     }
 
-    m_init_resnorm0 = resnorm0;
-    m_rhsnorm0 = rhsnorm0;
+    m_init_resnorm0 = max_of(resnorm0);
+    m_rhsnorm0 = max_of(rhsnorm0);
 
-    Real max_norm;
-    std::string norm_name;
-    if (always_use_bnorm or rhsnorm0 >= resnorm0) {
-        norm_name = "bnorm";
-        max_norm = rhsnorm0;
-    } else {
-        norm_name = "resid0";
-        max_norm = resnorm0;
+    Vector<Real> max_norm(ncol);
+    Vector<Real> res_target(ncol);
+    int nbnorm = 0;
+    for (int c = 0; c < ncol; ++c) {
+        if (always_use_bnorm or rhsnorm0[c] >= resnorm0[c]) {
+            max_norm[c] = rhsnorm0[c];
+            ++nbnorm;
+        } else {
+            max_norm[c] = resnorm0[c];
+        }
+        res_target[c] = std::max(a_tol_abs, std::max(a_tol_rel,Real(1.e-16))*max_norm[c]);
     }
-    const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,Real(1.e-16))*max_norm);
+    std::string norm_name = (nbnorm == ncol) ? "bnorm" : ((nbnorm == 0) ? "resid0" : "norm0");
 
-    if (!is_nsolve && resnorm0 <= res_target) {
-        composite_norminf = resnorm0;
+    // Largest relative norm, and whether every component has reached its target
+    auto rel_norm = [&] (Vector<Real> const& v) -> Real {
+        Real r = 0.0;
+        for (int c = 0; c < ncol; ++c) r = std::max(r, v[c]/max_norm[c]);
+        return r;
+    };
+    auto reached = [&] (Vector<Real> const& v) -> bool {
+        for (int c = 0; c < ncol; ++c) {
+            if (v[c] > res_target[c]) return false;
+        }
+        return true;
+    };
+
+    Vector<Real> composite_norm = resnorm0;
+
+    if (!is_nsolve && reached(resnorm0)) {
+        composite_norminf = max_of(resnorm0);
         if (verbose >= 1) {
             amrex::Print() << "MLMG: No iterations needed\n";
         }
@@ -134,48 +175,51 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
             if (is_nsolve) continue;
 
-            Real fine_norminf = ResNormInf(finest_amr_lev);
-            m_iter_fine_resnorm0.push_back(fine_norminf);
-            composite_norminf = fine_norminf;
+            Vector<Real> fine_norm = ResNormInfComps(finest_amr_lev);
+            m_iter_fine_resnorm0.push_back(max_of(fine_norm));
+            composite_norm = fine_norm;
             if (verbose >= 2) {
                 amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1 << " Fine resid/"
-                               << norm_name << " = " << fine_norminf/max_norm << "\n";
+                               << norm_name << " = " << rel_norm(fine_norm) << "\n";
             }
-            bool fine_converged = (fine_norminf <= res_target);
+            bool fine_converged = reached(fine_norm);
 
             if (namrlevs == 1 and fine_converged) {
                 converged = true;
             } else if (fine_converged) {
                 // finest level is converged, but we still need to test the coarse levels
                 computeMLResidual(finest_amr_lev-1);
-                Real crse_norminf = MLResNormInf(finest_amr_lev-1);
+                Vector<Real> crse_norm = MLResNormInfComps(finest_amr_lev-1);
                 if (verbose >= 2) {
                     amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1
                                    << " Crse resid/" << norm_name << " = "
-                                   << crse_norminf/max_norm << "\n";
+                                   << rel_norm(crse_norm) << "\n";
+                }
+                converged = reached(crse_norm);
+                for (int c = 0; c < ncol; ++c) {
+                    composite_norm[c] = std::max(fine_norm[c], crse_norm[c]);
                 }
-                converged = (crse_norminf <= res_target);
-                composite_norminf = std::max(fine_norminf, crse_norminf);
             } else {
                 converged = false;
             }
+            composite_norminf = max_of(composite_norm);
 
             if (converged) {
                 if (verbose >= 1) {
                     amrex::Print() << "MLMG: Final Iter. " << iter+1
                                    << " resid, resid/" << norm_name << " = "
                                    << composite_norminf << ", "
-                                   << composite_norminf/max_norm << "\n";
+                                   << rel_norm(composite_norm) << "\n";
                 }
                 break;
             } else {
-              if (composite_norminf > 1.e20*max_norm) 
+              if (rel_norm(composite_norm) > 1.e20)
               {
                   if (verbose > 0) {
                       amrex::Print() << "MLMG: Failing to converge after " << iter+1 << " iterations."
                                      << " resid, resid/" << norm_name << " = "
                                      << composite_norminf << ", "
-                                     << composite_norminf/max_norm << "\n";
+                                     << rel_norm(composite_norm) << "\n";
                       amrex::Abort("MLMG failing so lets stop here");
                   }
               }
@@ -187,7 +231,7 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
                 amrex::Print() << "MLMG: Failed to converge after " << max_iters << " iterations."
                                << " resid, resid/" << norm_name << " = "
                                << composite_norminf << ", "
-                               << composite_norminf/max_norm << "\n";
+                               << rel_norm(composite_norm) << "\n";
             }
             amrex::Abort("MLMG failed");
         }
@@ -409,6 +453,25 @@ std::string make_str (Ts... xs) {
     return oss.str();
 }
 
+// dst = src on the valid region, converting between precisions
+template <class DFAB, class SFAB>
+void convert_precision (FabArray<DFAB>& dst, FabArray<SFAB> const& src, int ncomp)
+{
+    using T = typename DFAB::value_type;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(dst, true); mfi.isValid(); ++mfi)
+    {
+        const auto& d = dst.array(mfi);
+        const auto& s = src.const_array(mfi);
+        amrex::LoopConcurrentOnCpu(mfi.tilebox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            d(i,j,k,n) = static_cast<T>(s(i,j,k,n));
+        });
+    }
+}
+
 }
 
 // in   : Residual (res) 
@@ -419,8 +482,9 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     BL_PROFILE("MLMG::mgVcycle()");
 
     const int mglev_bottom = linop.NMGLevels(amrlev) - 1;
+    const int mglev_single = (amrlev == 0) ? mixedPrecisionStart(mglev_top) : mglev_bottom;
 
-    for (int mglev = mglev_top; mglev < mglev_bottom; ++mglev)
+    for (int mglev = mglev_top; mglev < mglev_single; ++mglev)
     {
         std::string blp_mgv_down_lev_str = make_str("MLMG::mgVcycle_down::", mglev);
         BL_PROFILE_VAR(blp_mgv_down_lev_str, blp_mgv_down_lev);
@@ -434,14 +498,9 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
 
         cor[amrlev][mglev]->setVal(0.0);
         bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
-                         skip_fillboundary);
-            skip_fillboundary = false;
-        }
-
         // rescor = res - L(cor)
-        computeResOfCorrection(amrlev, mglev);
+        linop.smoothCorrectionResidual(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                                       rescor[amrlev][mglev], nu1, skip_fillboundary);
 
         if (verbose >= 4)
         {
@@ -456,7 +515,12 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     }
 
     BL_PROFILE_VAR("MLMG::mgVcycle_bottom", blp_bottom);
-    if (amrlev == 0)
+    if (mglev_single < mglev_bottom)
+    {
+        // The rest of the cycle, down to the bottom solve and back, in single precision
+        mgVcycleSingle(mglev_single);
+    }
+    else if (amrlev == 0)
     {
         if (verbose >= 4)
         {
@@ -484,11 +548,8 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
         }
         cor[amrlev][mglev_bottom]->setVal(0.0);
         bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
-                         skip_fillboundary);
-            skip_fillboundary = false;
-        }
+        linop.smoothSweeps(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
+                           nu1, skip_fillboundary);
         if (verbose >= 4)
         {
 	    computeResOfCorrection(amrlev, mglev_bottom);
@@ -499,7 +560,7 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     }
     BL_PROFILE_VAR_STOP(blp_bottom);
 
-    for (int mglev = mglev_bottom-1; mglev >= mglev_top; --mglev)
+    for (int mglev = mglev_single-1; mglev >= mglev_top; --mglev)
     {
         std::string blp_mgv_up_lev_str = make_str("MLMG::mgVcycle_up::", mglev);
         BL_PROFILE_VAR(blp_mgv_up_lev_str, blp_mgv_up_lev);
@@ -512,12 +573,13 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev
                            << "   UP: Norm before smooth " << norm << "\n";
         }
-        for (int i = 0; i < nu2; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev]);
+        if (cf_strategy == CFStrategy::ghostnodes) {
+            linop.smoothCorrectionResidual(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                                           rescor[amrlev][mglev], nu2);
+        } else {
+            linop.smoothSweeps(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev], nu2);
         }
 
-	if (cf_strategy == CFStrategy::ghostnodes) computeResOfCorrection(amrlev, mglev);
-
         if (verbose >= 4)
         {
 	    computeResOfCorrection(amrlev, mglev);
@@ -528,6 +590,74 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     }
 }
 
+// First MG level of the coarsest AMR level that mgVcycle runs in single
+// precision.  The bottom level is returned if there is none.
+int
+MLMG::mixedPrecisionStart (int mglev_top) const
+{
+    const int mglev_bottom = linop.NMGLevels(0) - 1;
+    if (!do_mixed_precision || cf_strategy != CFStrategy::none || Gpu::inLaunchRegion()) {
+        return mglev_bottom;
+    }
+    // The finest MG level stays in double precision.
+    const int mglev_single = std::max(mglev_top, 1);
+    for (int mglev = mglev_single; mglev <= mglev_bottom; ++mglev) {
+        if (!linop.supportsSinglePrecision(0, mglev)) return mglev_bottom;
+    }
+    return mglev_single;
+}
+
+// V-cycle on the MG levels of the coarsest AMR level from mglev_top down
+// in single precision.  The bottom solve is done in double precision.
+// in   : Residual (res) on mglev_top
+// out  : Correction (cor) on mglev_top
+void
+MLMG::mgVcycleSingle (int mglev_top)
+{
+    BL_PROFILE("MLMG::mgVcycleSingle()");
+
+    const int amrlev = 0;
+    const int mglev_bottom = linop.NMGLevels(amrlev) - 1;
+    const int ncomp = linop.getNComp();
+
+    convert_precision(fres[mglev_top], res[amrlev][mglev_top], ncomp);
+
+    for (int mglev = mglev_top; mglev < mglev_bottom; ++mglev)
+    {
+        fcor[mglev].setVal(0.0f);
+        bool skip_fillboundary = true;
+        linop.smoothSingle(amrlev, mglev, fcor[mglev], fres[mglev], nu1, skip_fillboundary);
+        linop.correctionResidualSingle(amrlev, mglev, frescor[mglev], fcor[mglev], fres[mglev]);
+        linop.restrictionSingle(amrlev, mglev+1, fres[mglev+1], frescor[mglev]);
+    }
+
+    convert_precision(res[amrlev][mglev_bottom], fres[mglev_bottom], ncomp);
+    bottomSolve();
+    convert_precision(fcor[mglev_bottom], *cor[amrlev][mglev_bottom], ncomp);
+
+    for (int mglev = mglev_bottom-1; mglev >= mglev_top; --mglev)
+    {
+        // cor_fine += I(cor_crse)
+        const fMultiFab& crse_cor = fcor[mglev+1];
+        fMultiFab&       fine_cor = fcor[mglev  ];
+        if (amrex::isMFIterSafe(crse_cor, fine_cor))
+        {
+            linop.interpolationSingle(amrlev, mglev, fine_cor, crse_cor);
+        }
+        else
+        {
+            const IntVect ratio = linop.mg_coarsen_ratio_vec[mglev];
+            fMultiFab cfine(amrex::coarsen(fine_cor.boxArray(), ratio),
+                            fine_cor.DistributionMap(), ncomp, 0);
+            cfine.ParallelCopy(crse_cor);
+            linop.interpolationSingle(amrlev, mglev, fine_cor, cfine);
+        }
+        linop.smoothSingle(amrlev, mglev, fine_cor, fres[mglev], nu2);
+    }
+
+    convert_precision(*cor[amrlev][mglev_top], fcor[mglev_top], ncomp);
+}
+
 // FMG cycle on the coarsest AMR level.
 // in:  Residual on the top MG level (i.e., 0)
 // out: Correction (cor) on all MG levels
@@ -920,10 +1050,7 @@ MLMG::actualBottomSolve ()
     {
 
         bool skip_fillboundary = true;
-        for (int i = 0; i < nuf; ++i) {
-            linop.smooth(amrlev, mglev, x, b, skip_fillboundary);
-            skip_fillboundary = false;
-        }
+        linop.smoothSweeps(amrlev, mglev, x, b, nuf, skip_fillboundary);
     }
     else
     {
@@ -947,12 +1074,24 @@ MLMG::actualBottomSolve ()
         {
             bottomSolveWithPETSc(x, *bottom_b);
         }
+        else if (bottom_solver == BottomSolver::fft)
+        {
+            bottomSolveWithFFT(x, *bottom_b);
+        }
+        else if (bottom_solver == BottomSolver::lu)
+        {
+            bottomSolveWithLU(x, *bottom_b);
+        }
         else
         {
             MLCGSolver::Type cg_type;
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipelined_bicgstab) {
+                cg_type = MLCGSolver::Type::PipelinedBiCGStab;
+            } else if (bottom_solver == BottomSolver::pipelined_cg) {
+                cg_type = MLCGSolver::Type::PipelinedCG;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -980,9 +1119,7 @@ MLMG::actualBottomSolve ()
                 }
             }
             const int n = (ret==0) ? nub : nuf;
-            for (int i = 0; i < n; ++i) {
-                linop.smooth(amrlev, mglev, x, b);
-            }
+            linop.smoothSweeps(amrlev, mglev, x, b, n);
         }
     }
 
@@ -991,6 +1128,36 @@ MLMG::actualBottomSolve ()
     timer[bottom_time] += amrex::second() - bottom_start_time;
 }
 
+void
+MLMG::bottomSolveWithFFT (MultiFab& x, const MultiFab& b)
+{
+    if (fft_bottom == nullptr)
+    {
+        std::string why;
+        if (!MLFFTBottom::isSupported(linop, &why)) {
+            amrex::Abort("MLMG: BottomSolver::fft cannot be used: " + why);
+        }
+        fft_bottom.reset(new MLFFTBottom(linop));
+    }
+    fft_bottom->solve(x, b);
+}
+
+void
+MLMG::bottomSolveWithLU (MultiFab& x, const MultiFab& b)
+{
+    if (lu_bottom == nullptr)
+    {
+        std::string why;
+        if (!MLLUBottom::isSupported(linop, &why)) {
+            amrex::Abort("MLMG: BottomSolver::lu cannot be used: " + why);
+        }
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(cf_strategy != CFStrategy::ghostnodes,
+                                         "MLMG: BottomSolver::lu does not support CFStrategy::ghostnodes");
+        lu_bottom.reset(new MLLUBottom(linop));
+    }
+    lu_bottom->solve(x, b);
+}
+
 int
 MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
 {
@@ -1008,14 +1175,17 @@ MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
     return ret;
 }
 
-// Compute single-level masked inf-norm of Residual (res).
-Real
-MLMG::ResNormInf (int alev, bool local)
+// Compute single-level masked inf-norm of Residual (res).  If the
+// components of the linear operator are independent, there is one norm
+// per component; otherwise there is a single norm over all components.
+Vector<Real>
+MLMG::ResNormInfComps (int alev, bool local)
 {
     BL_PROFILE("MLMG::ResNormInf()");
     const int ncomp = linop.getNComp();
+    const int ncol = linop.hasIndependentComps() ? ncomp : 1;
     const int mglev = 0;
-    Real norm = 0.0;
+    Vector<Real> norm(ncol, 0.0);
     MultiFab* pmf = &(res[alev][mglev]);
 #ifdef AMREX_USE_EB
     if (linop.isCellCentered() && scratch[alev]) {
@@ -1040,33 +1210,53 @@ MLMG::ResNormInf (int alev, bool local)
 	} else {
             newnorm = pmf->norm0(n,0,true);
 	}
-        norm = std::max(norm, newnorm);
+        const int c = (ncol == 1) ? 0 : n;
+        norm[c] = std::max(norm[c], newnorm);
     }
-    if (!local) ParallelAllReduce::Max(norm, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(norm.data(), ncol, ParallelContext::CommunicatorSub());
     return norm;
 }
 
-// Computes multi-level masked inf-norm of Residual (res).
 Real
-MLMG::MLResNormInf (int alevmax, bool local)
+MLMG::ResNormInf (int alev, bool local)
+{
+    Vector<Real> norm = ResNormInfComps(alev, local);
+    return *std::max_element(norm.begin(), norm.end());
+}
+
+// Computes multi-level masked inf-norm of Residual (res).
+Vector<Real>
+MLMG::MLResNormInfComps (int alevmax, bool local)
 {
     BL_PROFILE("MLMG::MLResNormInf()");
-    Real r = 0.0;
+    const int ncol = linop.hasIndependentComps() ? linop.getNComp() : 1;
+    Vector<Real> r(ncol, 0.0);
     for (int alev = 0; alev <= alevmax; ++alev)
     {
-        r = std::max(r, ResNormInf(alev,true));
+        Vector<Real> rlev = ResNormInfComps(alev,true);
+        for (int c = 0; c < ncol; ++c) {
+            r[c] = std::max(r[c], rlev[c]);
+        }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(r.data(), ncol, ParallelContext::CommunicatorSub());
     return r;
 }
 
-// Compute multi-level masked inf-norm of RHS (rhs).
 Real
-MLMG::MLRhsNormInf (bool local)
+MLMG::MLResNormInf (int alevmax, bool local)
+{
+    Vector<Real> r = MLResNormInfComps(alevmax, local);
+    return *std::max_element(r.begin(), r.end());
+}
+
+// Compute multi-level masked inf-norm of RHS (rhs).
+Vector<Real>
+MLMG::MLRhsNormInfComps (bool local)
 {
     BL_PROFILE("MLMG::MLRhsNormInf()");
     const int ncomp = linop.getNComp();
-    Real r = 0.0;
+    const int ncol = linop.hasIndependentComps() ? ncomp : 1;
+    Vector<Real> r(ncol, 0.0);
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
         MultiFab* pmf = &(rhs[alev]);
@@ -1087,17 +1277,25 @@ MLMG::MLRhsNormInf (bool local)
 #endif
         for (int n=0; n<ncomp; ++n)
         {
+            const int c = (ncol == 1) ? 0 : n;
             if (alev < finest_amr_lev) {
-                r = std::max(r, pmf->norm0(*fine_mask[alev],n,0,true));
+                r[c] = std::max(r[c], pmf->norm0(*fine_mask[alev],n,0,true));
             } else {
-                r = std::max(r, pmf->norm0(n,0,true));
+                r[c] = std::max(r[c], pmf->norm0(n,0,true));
             }
         }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(r.data(), ncol, ParallelContext::CommunicatorSub());
     return r;
 }
 
+Real
+MLMG::MLRhsNormInf (bool local)
+{
+    Vector<Real> r = MLRhsNormInfComps(local);
+    return *std::max_element(r.begin(), r.end());
+}
+
 void
 MLMG::buildFineMask ()
 {
@@ -1143,6 +1341,9 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     } else if (linop.needsUpdate()) {
         linop.update();
 
+        if (fft_bottom) fft_bottom->reset();
+        if (lu_bottom) lu_bottom->reset();
+
 #ifdef AMREX_USE_HYPRE
         hypre_solver.reset();
         hypre_bndry.reset();
@@ -1280,6 +1481,25 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
 
     buildFineMask();
 
+    if (do_mixed_precision && fres.empty())
+    {
+        // Single-precision copies of res, cor and rescor on the MG levels
+        // of the coarsest AMR level that mgVcycleSingle may use.
+        const int alev = 0;
+        const int nmglevs = linop.NMGLevels(alev);
+        fres.resize(nmglevs);
+        fcor.resize(nmglevs);
+        frescor.resize(nmglevs);
+        for (int mglev = 1; mglev < nmglevs; ++mglev)
+        {
+            const BoxArray& ba = res[alev][mglev].boxArray();
+            const DistributionMapping& dm = res[alev][mglev].DistributionMap();
+            fres[mglev].define(ba, dm, ncomp, 0);
+            fcor[mglev].define(ba, dm, ncomp, 1);
+            frescor[mglev].define(ba, dm, ncomp, 0);
+        }
+    }
+
     if (!solve_called)
     {
         scratch.resize(namrlevs);
@@ -1490,6 +1710,8 @@ MLMG::compResidual (const Vector<MultiFab*>& a_res, const Vector<MultiFab*>& a_s
         linop_prepared = true;
     } else if (linop.needsUpdate()) {
         linop.update();
+        if (fft_bottom) fft_bottom->reset();
+        if (lu_bottom) lu_bottom->reset();
     }
     
     const auto& amrrr = linop.AMRRefRatio();
@@ -1572,6 +1794,8 @@ MLMG::apply (const Vector<MultiFab*>& out, const Vector<MultiFab*>& a_in)
         linop_prepared = true;
     } else if (linop.needsUpdate()) {
         linop.update();
+        if (fft_bottom) fft_bottom->reset();
+        if (lu_bottom) lu_bottom->reset();
     }
 
     for (int alev = 0; alev < namrlevs; ++alev) {
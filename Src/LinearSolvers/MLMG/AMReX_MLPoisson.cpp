@@ -287,6 +287,102 @@ MLPoisson::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, i
     }
 }
 
+namespace {
+
+template <typename T>
+void mlpoisson_gsrb_box (Box const& box, Box const& bbox, Array4<T> const& sol,
+                         Array4<T const> const& rhs, const Real* dxinv,
+                         const Array<Array4<Real const>,2*AMREX_SPACEDIM>& f,
+                         const Array<Array4<int const>,2*AMREX_SPACEDIM>& m,
+                         int redblack)
+{
+    AMREX_D_TERM(const Real dhx = dxinv[0]*dxinv[0];,
+                 const Real dhy = dxinv[1]*dxinv[1];,
+                 const Real dhz = dxinv[2]*dxinv[2];);
+
+#if (AMREX_SPACEDIM == 1)
+    mlpoisson_gsrb(box, sol, rhs, dhx,
+                   f[0], m[0],
+                   f[1], m[1],
+                   bbox, redblack);
+#elif (AMREX_SPACEDIM == 2)
+    mlpoisson_gsrb(box, sol, rhs, dhx, dhy,
+                   f[0], m[0],
+                   f[1], m[1],
+                   f[2], m[2],
+                   f[3], m[3],
+                   bbox, redblack);
+#else
+    mlpoisson_gsrb(box, sol, rhs, dhx, dhy, dhz,
+                   f[0], m[0],
+                   f[1], m[1],
+                   f[2], m[2],
+                   f[3], m[3],
+                   f[4], m[4],
+                   f[5], m[5],
+                   bbox, redblack);
+#endif
+}
+
+template <typename T>
+void mlpoisson_resid_box (Box const& box, Array4<T> const& resid, Array4<T const> const& sol,
+                          Array4<T const> const& rhs, const Real* dxinv)
+{
+    AMREX_D_TERM(const Real dhx = dxinv[0]*dxinv[0];,
+                 const Real dhy = dxinv[1]*dxinv[1];,
+                 const Real dhz = dxinv[2]*dxinv[2];);
+
+    amrex::LoopConcurrentOnCpu(box, [=] (int i, int j, int k) noexcept
+    {
+#if (AMREX_SPACEDIM == 3)
+        mlpoisson_adotx(i, j, k, resid, sol, dhx, dhy, dhz);
+#elif (AMREX_SPACEDIM == 2)
+        mlpoisson_adotx(i, j, resid, sol, dhx, dhy);
+#else
+        mlpoisson_adotx(i, resid, sol, dhx);
+#endif
+        resid(i,j,k) = rhs(i,j,k) - resid(i,j,k);
+    });
+}
+
+}
+
+void
+MLPoisson::FsmoothBox (int amrlev, int mglev, const MFIter&, const Box& box, const Box& bbox,
+                       Array4<Real> const& sol, Array4<Real const> const& rhs,
+                       const Array<Array4<Real const>,2*AMREX_SPACEDIM>& f,
+                       const Array<Array4<int const>,2*AMREX_SPACEDIM>& m,
+                       int redblack) const
+{
+    mlpoisson_gsrb_box(box, bbox, sol, rhs, m_geom[amrlev][mglev].InvCellSize(), f, m, redblack);
+}
+
+void
+MLPoisson::FresidualBox (int amrlev, int mglev, const MFIter&, const Box& box,
+                         Array4<Real> const& resid, Array4<Real const> const& sol,
+                         Array4<Real const> const& rhs) const
+{
+    mlpoisson_resid_box(box, resid, sol, rhs, m_geom[amrlev][mglev].InvCellSize());
+}
+
+void
+MLPoisson::FsmoothBoxSingle (int amrlev, int mglev, const MFIter&, const Box& box, const Box& bbox,
+                             Array4<float> const& sol, Array4<float const> const& rhs,
+                             const Array<Array4<Real const>,2*AMREX_SPACEDIM>& f,
+                             const Array<Array4<int const>,2*AMREX_SPACEDIM>& m,
+                             int redblack) const
+{
+    mlpoisson_gsrb_box(box, bbox, sol, rhs, m_geom[amrlev][mglev].InvCellSize(), f, m, redblack);
+}
+
+void
+MLPoisson::FresidualBoxSingle (int amrlev, int mglev, const MFIter&, const Box& box,
+                               Array4<float> const& resid, Array4<float const> const& sol,
+                               Array4<float const> const& rhs) const
+{
+    mlpoisson_resid_box(box, resid, sol, rhs, m_geom[amrlev][mglev].InvCellSize());
+}
+
 void
 MLPoisson::FFlux (int amrlev, const MFIter& mfi,
                   const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
@@ -0,0 +1,201 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_PROB_AMR_F.H>
+
+#include <future>
+
+using namespace amrex;
+
+// Writes checkpoints with AsyncOut and checks that Amr renames chk*.temp
+// to chk* once all processes have finished writing, without waiting for
+// the next checkpoint: in retireFinishedCheckPoints, at the end of
+// coarseTimeStep, and in retireCheckPoints.  A checkpoint still being
+// written on one process must not be renamed.
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+void nullfill (Box const& /*bx*/, FArrayBox& /*data*/, const int /*dcomp*/, const int /*numcomp*/,
+               Geometry const& /*geom*/, const Real /*time*/, const Vector<BCRec>& /*bcr*/,
+               const int /*bcomp*/, const int /*scomp*/)
+{}
+
+// A single level that adds one to its state every step.
+class TestLevel
+    :
+    public AmrLevel
+{
+public:
+    TestLevel () {}
+    TestLevel (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& ba,
+               const DistributionMapping& dm, Real time)
+        : AmrLevel(papa, lev, level_geom, ba, dm, time) {}
+
+    static void variableSetUp ()
+    {
+        desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point,
+                               0, 1, &cell_cons_interp);
+        int lo_bc[AMREX_SPACEDIM];
+        int hi_bc[AMREX_SPACEDIM];
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            lo_bc[idim] = hi_bc[idim] = BCType::int_dir;
+        }
+        desc_lst.setComponent(0, 0, "phi", BCRec(lo_bc, hi_bc),
+                              StateDescriptor::BndryFunc(nullfill));
+    }
+
+    static void variableCleanUp () { desc_lst.clear(); }
+
+    virtual void computeInitialDt (int /*finest_level*/, int /*sub_cycle*/, Vector<int>& n_cycle,
+                                   const Vector<IntVect>& /*ref_ratio*/, Vector<Real>& dt_level,
+                                   Real /*stop_time*/) override
+    {
+        n_cycle[0] = 1;
+        dt_level[0] = 0.1;
+    }
+
+    virtual void computeNewDt (int /*finest_level*/, int /*sub_cycle*/, Vector<int>& n_cycle,
+                               const Vector<IntVect>& /*ref_ratio*/, Vector<Real>& /*dt_min*/,
+                               Vector<Real>& dt_level, Real /*stop_time*/,
+                               int /*post_regrid_flag*/) override
+    {
+        n_cycle[0] = 1;
+        dt_level[0] = 0.1;
+    }
+
+    virtual Real advance (Real /*time*/, Real dt, int /*iteration*/, int /*ncycle*/) override
+    {
+        state[0].allocOldData();
+        state[0].swapTimeLevels(dt);
+        MultiFab& S_new = get_new_data(0);
+        MultiFab::Copy(S_new, get_old_data(0), 0, 0, 1, 0);
+        S_new.plus(1.0, 0, 1, 0);
+        return dt;
+    }
+
+    virtual void post_timestep (int /*iteration*/) override {}
+    virtual void post_regrid (int /*lbase*/, int /*new_finest*/) override {}
+    virtual void post_init (Real /*stop_time*/) override {}
+    virtual void initData () override { get_new_data(0).setVal(0.0); }
+    virtual void init (AmrLevel& /*old*/) override { get_new_data(0).setVal(0.0); }
+    virtual void init () override { get_new_data(0).setVal(0.0); }
+    virtual void errorEst (TagBoxArray& /*tb*/, int /*clearval*/, int /*tagval*/, Real /*time*/,
+                           int /*n_error_buf*/, int /*ngrow*/) override {}
+};
+
+class TestLevelBld
+    :
+    public LevelBld
+{
+    virtual void variableSetUp () override { TestLevel::variableSetUp(); }
+    virtual void variableCleanUp () override { TestLevel::variableCleanUp(); }
+    virtual AmrLevel* operator() () override { return new TestLevel; }
+    virtual AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom,
+                                  const BoxArray& ba, const DistributionMapping& dm,
+                                  Real time) override
+    {
+        return new TestLevel(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+TestLevelBld test_bld;
+
+void checkRenamed (const std::string& name)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        if (!FileSystem::Exists(name+"/Header") || FileSystem::Exists(name+".temp")) {
+            amrex::Abort("CheckPoint: "+name+".temp has not been renamed");
+        }
+    }
+}
+
+void checkPending (const std::string& name)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        if (FileSystem::Exists(name) || !FileSystem::Exists(name+".temp")) {
+            amrex::Abort("CheckPoint: "+name+".temp has been renamed too early");
+        }
+    }
+}
+
+}
+
+LevelBld*
+getLevelBld ()
+{
+    return &test_bld;
+}
+
+extern "C"
+void amrex_probinit (const int* /*init*/, const int* /*name*/, const int* /*namelen*/,
+                     const amrex_real* /*problo*/, const amrex_real* /*probhi*/)
+{}
+
+void main_main ()
+{
+    AMREX_ALWAYS_ASSERT(AsyncOut::UseAsyncOut());
+
+    if (ParallelDescriptor::IOProcessor()) {
+        for (int step = 0; step < 4; ++step) {
+            const std::string& name = amrex::Concatenate("chk", step, 5);
+            FileSystem::RemoveAll(name);
+            FileSystem::RemoveAll(name+".temp");
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    const Real stop_time = 1.0;
+    Amr amr;
+    amr.init(0.0, stop_time);
+
+    // A finished checkpoint is renamed without writing another one.
+    amr.checkPoint();
+    AsyncOut::Finish();
+    amr.retireFinishedCheckPoints();
+    checkRenamed("chk00000");
+
+    // ... and at the end of the next coarse time step.
+    amr.coarseTimeStep(stop_time);
+    amr.checkPoint();
+    AsyncOut::Finish();
+    amr.coarseTimeStep(stop_time);
+    checkRenamed("chk00001");
+
+    // Hold up the background writes on the last process.  The checkpoint
+    // must stay pending until that process has finished too, even though
+    // the others have.
+    std::promise<void> gate;
+    if (ParallelDescriptor::MyProc() == ParallelDescriptor::NProcs()-1) {
+        std::shared_future<void> opened = gate.get_future().share();
+        AsyncOut::Submit([=] () { opened.wait(); });
+    }
+    amr.checkPoint();
+    if (ParallelDescriptor::MyProc() != ParallelDescriptor::NProcs()-1) {
+        AsyncOut::Finish();
+    }
+    amr.retireFinishedCheckPoints();
+    checkPending("chk00002");
+    amr.coarseTimeStep(stop_time);
+    checkPending("chk00002");
+
+    gate.set_value();
+    amr.retireCheckPoints(0);
+    checkRenamed("chk00002");
+
+    amrex::Print() << "CheckPoint: checkpoints are renamed once they are written\n";
+}
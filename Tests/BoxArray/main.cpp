@@ -0,0 +1,203 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_BaseFab.H>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+using namespace amrex;
+
+// Checks BoxArray::intersections, BoxArray::complementIn, and
+// BoxArray::removeOverlap against brute force for BoxArrays that mix one
+// large box with many small ones, so that the boxes fall into different
+// size classes of the index.
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+std::mt19937 rng(42);
+
+int randomInt (int lo, int hi)
+{
+    return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+Box randomBox (const Box& domain, int minsize, int maxsize)
+{
+    IntVect lo, hi;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int len = randomInt(minsize, maxsize);
+        lo[idim] = randomInt(domain.smallEnd(idim)-len/2, domain.bigEnd(idim)-len/2);
+        hi[idim] = lo[idim] + len - 1;
+    }
+    return Box(lo, hi, domain.ixType());
+}
+
+// Number of times each cell of domain is covered by the boxes of ba
+BaseFab<int> coverCount (const BoxArray& ba, const Box& domain)
+{
+    BaseFab<int> count(domain, 1);
+    count.setVal<RunOn::Host>(0);
+    auto const& a = count.array();
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        const Box& b = ba[i] & domain;
+        if (b.ok()) {
+            amrex::LoopOnCpu(b, [&] (int ii, int jj, int kk) { a(ii,jj,kk) += 1; });
+        }
+    }
+    return count;
+}
+
+void checkIntersections (const BoxArray& ba, const Box& bx, int ng)
+{
+    std::vector<std::pair<int,Box> > isects = ba.intersections(bx, false, ng);
+    std::sort(isects.begin(), isects.end(),
+              [] (const std::pair<int,Box>& a, const std::pair<int,Box>& b) { return a.first < b.first; });
+
+    std::vector<std::pair<int,Box> > brute;
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        const Box& b = amrex::grow(ba[i], ng) & bx;
+        if (b.ok()) brute.push_back(std::make_pair(i, b));
+    }
+
+    if (isects != brute) {
+        amrex::Abort("BoxArray: intersections of "+std::to_string(ba.size())+" boxes with a box"
+                     " differ from brute force");
+    }
+    if (ba.intersects(bx, ng) != !brute.empty()) {
+        amrex::Abort("BoxArray: intersects differs from brute force");
+    }
+    if (!brute.empty()) {
+        std::vector<std::pair<int,Box> > first = ba.intersections(bx, true, ng);
+        if (first.size() != 1 ||
+            std::find(brute.begin(), brute.end(), first[0]) == brute.end()) {
+            amrex::Abort("BoxArray: intersections with first_only is not one of the intersections");
+        }
+    }
+}
+
+void checkComplementIn (const BoxArray& ba, const Box& bx)
+{
+    const BoxList& bl = ba.complementIn(bx);
+
+    Long npts = 0;
+    for (const Box& b : bl) {
+        if (!bx.contains(b)) {
+            amrex::Abort("BoxArray: complementIn returned a box outside of the box");
+        }
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            if (ba[i].intersects(b)) {
+                amrex::Abort("BoxArray: complementIn returned a box that intersects the BoxArray");
+            }
+        }
+        npts += b.numPts();
+    }
+
+    // ba is disjoint, so the intersections and the complement partition bx.
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        const Box& b = ba[i] & bx;
+        if (b.ok()) npts += b.numPts();
+    }
+    if (npts != bx.numPts()) {
+        amrex::Abort("BoxArray: complementIn and the BoxArray do not cover the box");
+    }
+}
+
+void checkRemoveOverlap (BoxArray ba, const Box& domain)
+{
+    const BaseFab<int>& before = coverCount(ba, domain);
+    ba.removeOverlap();
+    const BaseFab<int>& after = coverCount(ba, domain);
+
+    auto const& b = before.const_array();
+    auto const& a = after.const_array();
+    amrex::LoopOnCpu(domain, [&] (int i, int j, int k)
+    {
+        if (a(i,j,k) != std::min(b(i,j,k),1)) {
+            amrex::Abort("BoxArray: removeOverlap changed the covered cells or left an overlap");
+        }
+    });
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int n_small = 1000;
+    int n_queries = 500;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("n_small", n_small);
+        pp.query("n_queries", n_queries);
+    }
+
+    const Box domain(IntVect(0), IntVect(n_cell-1));
+    const Box big(IntVect(n_cell/8), IntVect(n_cell/8 + n_cell/2 - 1));
+
+    for (const IntVect& typ : {IntVect::TheCellVector(), IntVect::TheNodeVector()})
+    {
+        // A disjoint BoxArray: the large box and the boxes of its complement
+        // chopped into small ones, with some of them removed.
+        BoxArray disjoint;
+        {
+            BoxArray cba = amrex::complementIn(domain, BoxArray(big));
+            cba.maxSize(4);
+            BoxList bl(big);
+            for (int i = 0, N = cba.size(); i < N; ++i) {
+                if (randomInt(0,4) > 0) {
+                    BoxArray small(cba[i]);
+                    small.maxSize(randomInt(2,4));
+                    for (int j = 0, M = small.size(); j < M; ++j) {
+                        bl.push_back(small[j]);
+                    }
+                }
+            }
+            disjoint = BoxArray(std::move(bl));
+        }
+        AMREX_ALWAYS_ASSERT(disjoint.isDisjoint());
+        disjoint.convert(typ);
+
+        const Box& tdomain = amrex::convert(domain, typ);
+        for (int iq = 0; iq < n_queries; ++iq)
+        {
+            const int maxsize = (iq % 10 == 0) ? n_cell : 8;
+            const Box& bx = randomBox(tdomain, 1, maxsize);
+            checkIntersections(disjoint, bx, 0);
+            checkIntersections(disjoint, bx, randomInt(1,3));
+            if (typ == IntVect::TheCellVector()) {
+                checkComplementIn(disjoint, bx);
+            }
+        }
+
+        // Overlapping boxes: the large box and many small ones on top of it
+        // and each other.
+        BoxList bl(amrex::convert(big, typ));
+        for (int i = 0; i < n_small; ++i) {
+            bl.push_back(randomBox(tdomain, 1, 6) & tdomain);
+        }
+        BoxArray overlapping(std::move(bl));
+
+        for (int iq = 0; iq < n_queries; ++iq) {
+            checkIntersections(overlapping, randomBox(tdomain, 1, 12), 0);
+        }
+        if (typ == IntVect::TheCellVector()) {
+            checkRemoveOverlap(overlapping, domain);
+        }
+    }
+
+    amrex::Print() << "BoxArray: all tests passed\n";
+}
@@ -0,0 +1,159 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF_Box.H>
+#include <AMReX_EB2_IF_Sphere.H>
+#include <AMReX_EB2_IF_Union.H>
+#include <AMReX_EB2_IF_Translation.H>
+#include <AMReX_EBFabFactory.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+using ImpFunc = EB2::TranslationIF<EB2::UnionIF<EB2::SphereIF,EB2::BoxIF> >;
+
+ImpFunc makeIF (Real radius)
+{
+    EB2::SphereIF sphere(radius, {AMREX_D_DECL(0.,0.,0.)}, false);
+    EB2::BoxIF box({AMREX_D_DECL(-0.1,-0.6,-0.1)}, {AMREX_D_DECL(0.1,0.6,0.1)}, false);
+    return EB2::translate(EB2::makeUnion(sphere, box), {AMREX_D_DECL(0.5,0.5,0.5)});
+}
+
+void compare (const MultiFab& a, const MultiFab& b, const std::string& what)
+{
+    MultiFab diff(a.boxArray(), a.DistributionMap(), a.nComp(), 0);
+    MultiFab::Copy(diff, a, 0, 0, a.nComp(), 0);
+    MultiFab::Subtract(diff, b, 0, 0, a.nComp(), 0);
+    for (int n = 0; n < a.nComp(); ++n) {
+        const Real err = diff.norm0(n);
+        if (err != 0.0) {
+            amrex::Abort("IndexSpaceCache: "+what+" differs after reading the cache");
+        }
+    }
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    std::string cache_dir;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        ParmParse ppeb2("eb2");
+        ppeb2.get("cache_dir", cache_dir);
+    }
+
+    if (ParallelDescriptor::IOProcessor() && FileSystem::Exists(cache_dir)) {
+        FileSystem::RemoveAll(cache_dir);
+    }
+    ParallelDescriptor::Barrier();
+
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Geometry geom(Box(IntVect(0),IntVect(n_cell-1)), rb, 0, is_periodic);
+    BoxArray ba(geom.Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int max_coarsening_level = 2;
+
+    // The first build writes the cache, the second one reads it.
+    const ImpFunc impfunc = makeIF(0.3);
+    auto gshop = EB2::makeShop(impfunc);
+    const std::string& cache_name = EB2::IndexSpaceCacheName(geom, 0, max_coarsening_level, 4, true,
+                                                             EB2::ExtendDomainFace(), nullptr);
+    std::string params;
+    AMREX_ALWAYS_ASSERT(EB2::ImpFuncParams(impfunc, params));
+    const std::string& name = EB2::IndexSpaceCacheName(geom, 0, max_coarsening_level, 4, true,
+                                                       EB2::ExtendDomainFace(), &params);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(cache_name.empty(),
+                                     "an unhashable implicit function must not be cached without eb2.cache_key");
+    AMREX_ALWAYS_ASSERT(!EB2::IndexSpaceCacheExists(name));
+
+    EB2::Build(gshop, geom, 0, max_coarsening_level);
+    const EB2::IndexSpace* built = &EB2::IndexSpace::top();
+    AMREX_ALWAYS_ASSERT(EB2::IndexSpaceCacheExists(name));
+
+    EB2::Build(gshop, geom, 0, max_coarsening_level);
+    const EB2::IndexSpace* read = &EB2::IndexSpace::top();
+    AMREX_ALWAYS_ASSERT(built != read);
+
+    // A different radius must not reuse the cache.
+    std::string params2;
+    EB2::ImpFuncParams(makeIF(0.31), params2);
+    AMREX_ALWAYS_ASSERT(params2 != params);
+    const std::string& name2 = EB2::IndexSpaceCacheName(geom, 0, max_coarsening_level, 4, true,
+                                                        EB2::ExtendDomainFace(), &params2);
+    AMREX_ALWAYS_ASSERT(name2 != name);
+    AMREX_ALWAYS_ASSERT(!EB2::IndexSpaceCacheExists(name2));
+
+    // Nor must a different eb2.small_volfrac, which GShopLevel reads itself.
+    {
+        ParmParse ppeb2("eb2");
+        Real small_volfrac = 1.e-14;
+        ppeb2.query("small_volfrac", small_volfrac);
+        ppeb2.add("small_volfrac", 1.e-4);
+        const std::string& name3 = EB2::IndexSpaceCacheName(geom, 0, max_coarsening_level, 4, true,
+                                                            EB2::ExtendDomainFace(), &params);
+        AMREX_ALWAYS_ASSERT(name3 != name);
+        AMREX_ALWAYS_ASSERT(!EB2::IndexSpaceCacheExists(name3));
+        ppeb2.add("small_volfrac", small_volfrac);
+        AMREX_ALWAYS_ASSERT(EB2::IndexSpaceCacheName(geom, 0, max_coarsening_level, 4, true,
+                                                     EB2::ExtendDomainFace(), &params) == name);
+    }
+
+    for (int ilev = 0; ilev <= max_coarsening_level; ++ilev)
+    {
+        const Geometry cgeom(amrex::coarsen(geom.Domain(), 1<<ilev), rb, 0, is_periodic);
+        BoxArray cba = amrex::coarsen(ba, 1<<ilev);
+        auto fact_built = amrex::makeEBFabFactory(built, cgeom, cba, dm, {1,1,1}, EBSupport::full);
+        auto fact_read  = amrex::makeEBFabFactory(read,  cgeom, cba, dm, {1,1,1}, EBSupport::full);
+
+        compare(fact_built->getVolFrac(), fact_read->getVolFrac(), "volfrac");
+        compare(fact_built->getCentroid().ToMultiFab(0.,0.),
+                fact_read->getCentroid().ToMultiFab(0.,0.), "centroid");
+        compare(fact_built->getBndryArea().ToMultiFab(0.,0.),
+                fact_read->getBndryArea().ToMultiFab(0.,0.), "bndryarea");
+        compare(fact_built->getBndryNormal().ToMultiFab(0.,0.),
+                fact_read->getBndryNormal().ToMultiFab(0.,0.), "bndrynormal");
+        const auto& afrac_built = fact_built->getAreaFrac();
+        const auto& afrac_read  = fact_read->getAreaFrac();
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            compare(afrac_built[idim]->ToMultiFab(1.,0.), afrac_read[idim]->ToMultiFab(1.,0.),
+                    "areafrac");
+        }
+
+        const auto& flag_built = fact_built->getMultiEBCellFlagFab();
+        const auto& flag_read  = fact_read->getMultiEBCellFlagFab();
+        for (MFIter mfi(flag_built); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            const auto& fb = flag_built[mfi];
+            const auto& fr = flag_read[mfi];
+            AMREX_ALWAYS_ASSERT(fb.getType(bx) == fr.getType(bx));
+            for (BoxIterator bi(bx); bi.ok(); ++bi) {
+                if (fb(bi()) != fr(bi())) {
+                    amrex::Abort("IndexSpaceCache: cell flags differ after reading the cache");
+                }
+            }
+        }
+    }
+
+    amrex::Print() << "IndexSpaceCache: the cached IndexSpace matches the built one\n";
+}
@@ -0,0 +1,384 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_EB2_BVH.H>
+#include <AMReX_EB2_IF_STL.H>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <random>
+
+using namespace amrex;
+
+// Compares EB2::BVH::nearest with a linear scan over random triangles, and
+// the signed distance of EB2::STLIF with a brute-force search over the
+// triangles of two closed surfaces: a tetrahedron read from an ASCII STL
+// file, and a cube with a pyramidal dent in its top face, which has
+// concave edges and a concave vertex.  The query points include points
+// close to the edges and vertices, where the sign is given by the
+// pseudo-normals.
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+#if (AMREX_SPACEDIM == 3)
+
+namespace {
+
+using Triangle = Array<RealArray,3>;
+
+RealArray sub (const RealArray& a, const RealArray& b) {
+    return RealArray{{a[0]-b[0], a[1]-b[1], a[2]-b[2]}};
+}
+
+RealArray axpy (const RealArray& y, Real a, const RealArray& x) {
+    return RealArray{{y[0]+a*x[0], y[1]+a*x[1], y[2]+a*x[2]}};
+}
+
+Real dot (const RealArray& a, const RealArray& b) {
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+RealArray cross (const RealArray& a, const RealArray& b) {
+    return RealArray{{a[1]*b[2]-a[2]*b[1], a[2]*b[0]-a[0]*b[2], a[0]*b[1]-a[1]*b[0]}};
+}
+
+Real norm (const RealArray& a) { return std::sqrt(dot(a,a)); }
+
+// Distance from p to triangle t (Ericson, Real-Time Collision Detection).
+Real distance (const RealArray& p, const Triangle& t)
+{
+    const RealArray& a = t[0];
+    const RealArray& b = t[1];
+    const RealArray& c = t[2];
+    const RealArray ab = sub(b,a);
+    const RealArray ac = sub(c,a);
+    const RealArray ap = sub(p,a);
+    const Real d1 = dot(ab,ap);
+    const Real d2 = dot(ac,ap);
+    if (d1 <= 0.0 && d2 <= 0.0) return norm(ap);
+
+    const RealArray bp = sub(p,b);
+    const Real d3 = dot(ab,bp);
+    const Real d4 = dot(ac,bp);
+    if (d3 >= 0.0 && d4 <= d3) return norm(bp);
+
+    const Real vc = d1*d4 - d3*d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+        return norm(sub(p, axpy(a, d1/(d1-d3), ab)));
+    }
+
+    const RealArray cp = sub(p,c);
+    const Real d5 = dot(ab,cp);
+    const Real d6 = dot(ac,cp);
+    if (d6 >= 0.0 && d5 <= d6) return norm(cp);
+
+    const Real vb = d5*d2 - d1*d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+        return norm(sub(p, axpy(a, d2/(d2-d6), ac)));
+    }
+
+    const Real va = d3*d6 - d5*d4;
+    if (va <= 0.0 && (d4-d3) >= 0.0 && (d5-d6) >= 0.0) {
+        return norm(sub(p, axpy(b, (d4-d3)/((d4-d3)+(d5-d6)), sub(c,b))));
+    }
+
+    const Real denom = 1.0/(va+vb+vc);
+    return norm(sub(p, axpy(axpy(a, vb*denom, ab), vc*denom, ac)));
+}
+
+// Points at distances 1e-3 and 1e-7 in random directions around the
+// vertices, the edge midpoints and random points on the edges of t.
+void nearFeatures (const Triangle& t, std::mt19937& gen, Vector<RealArray>& points)
+{
+    std::uniform_real_distribution<Real> unif(-1.0, 1.0);
+    std::uniform_real_distribution<Real> unit(0.0, 1.0);
+    Vector<RealArray> features(t.begin(), t.end());
+    for (int i = 0; i < 3; ++i) {
+        const RealArray& a = t[i];
+        const RealArray& b = t[(i+1)%3];
+        features.push_back(axpy(a, 0.5, sub(b,a)));
+        features.push_back(axpy(a, unit(gen), sub(b,a)));
+    }
+    for (const auto& f : features) {
+        for (Real eps : {1.e-3, 1.e-7}) {
+            for (int n = 0; n < 4; ++n) {
+                RealArray dir{{unif(gen), unif(gen), unif(gen)}};
+                const Real l = norm(dir);
+                if (l < 1.e-3) continue;
+                points.push_back(axpy(f, eps/l, dir));
+            }
+        }
+    }
+}
+
+void testBVH ()
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<Real> pos(0.0, 1.0);
+    std::uniform_real_distribution<Real> off(-0.05, 0.05);
+
+    Vector<Triangle> tri;
+    for (int i = 0; i < 500; ++i) {
+        const RealArray c{{pos(gen), pos(gen), pos(gen)}};
+        Triangle t;
+        for (auto& v : t) {
+            v = RealArray{{c[0]+off(gen), c[1]+off(gen), c[2]+off(gen)}};
+        }
+        tri.push_back(t);
+    }
+    // Duplicates must resolve to the lowest index.
+    for (int i = 0; i < 20; ++i) {
+        tri.push_back(tri[7*i]);
+    }
+
+    Vector<RealArray> lo(tri.size()), hi(tri.size());
+    for (int i = 0; i < tri.size(); ++i) {
+        for (int idim = 0; idim < 3; ++idim) {
+            lo[i][idim] = std::min({tri[i][0][idim], tri[i][1][idim], tri[i][2][idim]});
+            hi[i][idim] = std::max({tri[i][0][idim], tri[i][1][idim], tri[i][2][idim]});
+        }
+    }
+
+    Vector<RealArray> points;
+    std::uniform_real_distribution<Real> wide(-0.3, 1.3);
+    for (int i = 0; i < 2000; ++i) {
+        points.push_back(RealArray{{wide(gen), wide(gen), wide(gen)}});
+    }
+    for (int i = 0; i < 50; ++i) {
+        nearFeatures(tri[11*i], gen, points);
+    }
+
+    for (int leaf_size : {1, 4, 16})
+    {
+        EB2::BVH bvh(lo, hi, leaf_size);
+        AMREX_ALWAYS_ASSERT(bvh.numPrimitives() == tri.size());
+        for (const auto& p : points)
+        {
+            int iprim;
+            const Real d = bvh.nearest(p, [&] (int i) { return distance(p, tri[i]); }, iprim);
+
+            int iref = -1;
+            Real dref = std::numeric_limits<Real>::max();
+            for (int i = 0; i < tri.size(); ++i) {
+                const Real di = distance(p, tri[i]);
+                if (di < dref) {
+                    dref = di;
+                    iref = i;
+                }
+            }
+            if (iprim != iref || d != dref) {
+                amrex::Abort("STL: BVH::nearest found triangle "+std::to_string(iprim)
+                             +" instead of "+std::to_string(iref));
+            }
+        }
+    }
+
+    EB2::BVH empty;
+    int iprim = 0;
+    empty.nearest(RealArray{{0.,0.,0.}}, [] (int) { return Real(0.); }, iprim);
+    AMREX_ALWAYS_ASSERT(iprim == -1);
+
+    amrex::Print() << "STL: BVH::nearest agrees with the linear scan at "
+                   << points.size() << " points\n";
+}
+
+struct Surface
+{
+    Vector<Triangle> tri;
+    std::function<bool(const RealArray&)> inside;
+
+    // Orient the triangles so that their normals point out of the volume.
+    void orient ()
+    {
+        for (auto& t : tri) {
+            const RealArray n = cross(sub(t[1],t[0]), sub(t[2],t[0]));
+            RealArray c{{0.,0.,0.}};
+            for (const auto& v : t) c = axpy(c, 1./3., v);
+            if (inside(axpy(c, 1.e-4/norm(n), n))) {
+                std::swap(t[1], t[2]);
+            }
+        }
+    }
+
+    Vector<RealArray> vertices () const
+    {
+        Vector<RealArray> v;
+        for (const auto& t : tri) {
+            v.insert(v.end(), t.begin(), t.end());
+        }
+        return v;
+    }
+};
+
+Surface tetrahedron ()
+{
+    const RealArray v[4] = {{{0.11,0.13,0.17}}, {{0.93,0.21,0.09}},
+                            {{0.37,0.89,0.23}}, {{0.41,0.38,0.86}}};
+    Surface s;
+    for (int i = 0; i < 4; ++i) {
+        s.tri.push_back(Triangle{{v[i], v[(i+1)%4], v[(i+2)%4]}});
+    }
+    const Vector<Triangle> faces = s.tri;
+    s.inside = [faces, v] (const RealArray& p) -> bool {
+        for (int i = 0; i < 4; ++i) {
+            const Triangle& t = faces[i];
+            const RealArray n = cross(sub(t[1],t[0]), sub(t[2],t[0]));
+            // The fourth vertex is on the inner side of the face.
+            const Real s4 = dot(sub(v[(i+3)%4],t[0]), n);
+            if (dot(sub(p,t[0]), n)*s4 <= 0.0) return false;
+        }
+        return true;
+    };
+    s.orient();
+    return s;
+}
+
+// The cube [0.2,0.8]^3, whose top face is replaced by four triangles
+// meeting at (0.5,0.5,0.6).
+Surface dentedCube ()
+{
+    const Real l = 0.2, h = 0.8;
+    auto corner = [=] (int i, int j, int k) {
+        return RealArray{{i ? h : l, j ? h : l, k ? h : l}};
+    };
+    Surface s;
+    // Bottom and sides
+    for (int idim = 0; idim < 3; ++idim) {
+        for (int side = 0; side < 2; ++side) {
+            if (idim == 2 && side == 1) continue;
+            RealArray q[4];
+            for (int m = 0; m < 4; ++m) {
+                int ijk[3];
+                ijk[idim] = side;
+                ijk[(idim+1)%3] = (m == 1 || m == 2);
+                ijk[(idim+2)%3] = (m >= 2);
+                q[m] = corner(ijk[0], ijk[1], ijk[2]);
+            }
+            s.tri.push_back(Triangle{{q[0], q[1], q[2]}});
+            s.tri.push_back(Triangle{{q[0], q[2], q[3]}});
+        }
+    }
+    // The dent
+    const RealArray apex{{0.5, 0.5, 0.6}};
+    const RealArray top[4] = {corner(0,0,1), corner(1,0,1), corner(1,1,1), corner(0,1,1)};
+    for (int m = 0; m < 4; ++m) {
+        s.tri.push_back(Triangle{{top[m], top[(m+1)%4], apex}});
+    }
+    s.inside = [=] (const RealArray& p) -> bool {
+        for (int idim = 0; idim < 3; ++idim) {
+            if (p[idim] <= l || p[idim] >= h) return false;
+        }
+        const Real r = std::max(std::abs(p[0]-0.5), std::abs(p[1]-0.5));
+        return p[2] < 0.6 + (h-0.6)*r/(0.5-l);
+    };
+    s.orient();
+    return s;
+}
+
+void writeSTL (const std::string& name, const Surface& s)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream ofs(name);
+        ofs.precision(17);
+        ofs << "solid test\n";
+        for (const auto& t : s.tri) {
+            const RealArray n = cross(sub(t[1],t[0]), sub(t[2],t[0]));
+            ofs << "  facet normal " << n[0] << " " << n[1] << " " << n[2] << "\n"
+                << "    outer loop\n";
+            for (const auto& v : t) {
+                ofs << "      vertex " << v[0] << " " << v[1] << " " << v[2] << "\n";
+            }
+            ofs << "    endloop\n"
+                << "  endfacet\n";
+        }
+        ofs << "endsolid test\n";
+    }
+    ParallelDescriptor::Barrier();
+}
+
+void testSTLIF (const std::string& what, const Surface& s, const EB2::STLIF& f_in,
+                const EB2::STLIF& f_out)
+{
+    AMREX_ALWAYS_ASSERT(f_in.numTriangles() == s.tri.size());
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<Real> wide(-0.1, 1.1);
+    Vector<RealArray> points;
+    for (int i = 0; i < 4000; ++i) {
+        points.push_back(RealArray{{wide(gen), wide(gen), wide(gen)}});
+    }
+    for (const auto& t : s.tri) {
+        nearFeatures(t, gen, points);
+    }
+    // Along the concave edges of the dent and toward its vertex.
+    for (int i = 1; i <= 20; ++i) {
+        const Real e = std::pow(10.0, -0.3*i);
+        points.push_back(RealArray{{0.5, 0.5, 0.6+e}});
+        points.push_back(RealArray{{0.5, 0.5, 0.6-e}});
+        points.push_back(RealArray{{0.5+0.1, 0.5+0.1, 0.6+0.2*0.1/0.3+e}});
+        points.push_back(RealArray{{0.5+0.1, 0.5+0.1, 0.6+0.2*0.1/0.3-e}});
+    }
+
+    Long nin = 0;
+    for (const auto& p : points)
+    {
+        Real dref = std::numeric_limits<Real>::max();
+        for (const auto& t : s.tri) {
+            dref = std::min(dref, distance(p, t));
+        }
+        // The sign is not well defined on the surface.
+        if (dref < 1.e-12) continue;
+
+        const bool inside = s.inside(p);
+        if (inside) ++nin;
+        const Real expected = inside ? -dref : dref;
+
+        // With the fluid inside, the body is outside and positive.
+        const Real d_in = f_in(p);
+        const Real d_out = f_out(p);
+        if (std::abs(d_in - expected) > 1.e-12 || std::abs(d_out + expected) > 1.e-12) {
+            amrex::Abort("STL: wrong signed distance to the "+what+" at ("
+                         +std::to_string(p[0])+","+std::to_string(p[1])+","
+                         +std::to_string(p[2])+")");
+        }
+    }
+
+    amrex::Print() << "STL: the signed distance to the " << what << " is right at "
+                   << points.size() << " points, " << nin << " inside\n";
+}
+
+}
+
+void main_main ()
+{
+    testBVH();
+
+    const Surface tet = tetrahedron();
+    writeSTL("stl_test_tetrahedron.stl", tet);
+    testSTLIF("tetrahedron", tet, EB2::STLIF("stl_test_tetrahedron.stl", true),
+              EB2::STLIF("stl_test_tetrahedron.stl", false));
+
+    const Surface cube = dentedCube();
+    testSTLIF("dented cube", cube, EB2::STLIF(cube.vertices(), true),
+              EB2::STLIF(cube.vertices(), false));
+
+    amrex::Print() << "STL: all tests passed\n";
+}
+
+#else
+
+void main_main ()
+{
+    amrex::Print() << "STL: STLIF is only available in 3D\n";
+}
+
+#endif
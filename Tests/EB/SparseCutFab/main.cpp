@@ -0,0 +1,149 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF_Sphere.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBMultiFabUtil.H>
+#include <AMReX_EBMultiFabUtil_C.H>
+#include <AMReX_SparseCutFab.H>
+
+// Checks that the sparse copies of the EB data match the dense MultiCutFabs
+// they are built from, and that EB_interp_CC_to_Centroid, which reads the
+// sparse centroid, matches the dense eb_interp_cc2cent kernel.
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+void compare (const MultiFab& a, const MultiFab& b, int ngrow, const std::string& what)
+{
+    AMREX_ALWAYS_ASSERT(a.nComp() == b.nComp());
+    MultiFab diff(a.boxArray(), a.DistributionMap(), a.nComp(), ngrow);
+    MultiFab::Copy(diff, a, 0, 0, a.nComp(), ngrow);
+    MultiFab::Subtract(diff, b, 0, 0, a.nComp(), ngrow);
+    for (int n = 0; n < a.nComp(); ++n) {
+        const Real err = diff.norm0(n, ngrow);
+        if (err != 0.0) {
+            amrex::Abort("SparseCutFab: "+what+" differs from the dense data, error = "
+                         +std::to_string(err));
+        }
+    }
+}
+
+void compare (const MultiSparseCutFab& sparse, const MultiCutFab& dense,
+              Real regular_value, Real covered_value, const std::string& what)
+{
+    AMREX_ALWAYS_ASSERT(sparse.nGrow() == dense.nGrow());
+    compare(sparse.ToMultiFab(), dense.ToMultiFab(regular_value, covered_value),
+            dense.nGrow(), what);
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Geometry geom(Box(IntVect(0),IntVect(n_cell-1)), rb, 0, is_periodic);
+    BoxArray ba(geom.Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    EB2::SphereIF sphere(0.31, {AMREX_D_DECL(0.5,0.52,0.49)}, false);
+    auto gshop = EB2::makeShop(sphere);
+    EB2::Build(gshop, geom, 0, 0);
+
+    auto factory = amrex::makeEBFabFactory(geom, ba, dm, {2,2,2}, EBSupport::full);
+
+    // The sparse copies must reproduce the dense data, ghost cells included.
+    compare(factory->getSparseVolFrac().ToMultiFab(), factory->getVolFrac(),
+            factory->getVolFrac().nGrow(), "volfrac");
+    compare(factory->getSparseCentroid(), factory->getCentroid(), 0., 0., "centroid");
+    compare(factory->getSparseBndryCent(), factory->getBndryCent(), -1., -1., "bndrycent");
+    compare(factory->getSparseBndryArea(), factory->getBndryArea(), 0., 0., "bndryarea");
+    compare(factory->getSparseBndryNormal(), factory->getBndryNormal(), 0., 0., "bndrynormal");
+    const auto& areafrac = factory->getAreaFrac();
+    const auto& facecent = factory->getFaceCent();
+    const auto& sparse_areafrac = factory->getSparseAreaFrac();
+    const auto& sparse_facecent = factory->getSparseFaceCent();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        compare(*sparse_areafrac[idim], *areafrac[idim], 1., 0., "areafrac");
+        compare(*sparse_facecent[idim], *facecent[idim], 0., 0., "facecent");
+    }
+
+    // A second call returns the same copy.
+    AMREX_ALWAYS_ASSERT(&factory->getSparseCentroid() == &factory->getSparseCentroid());
+
+    // Only the cut cells are stored.
+    const auto& flags = factory->getMultiEBCellFlagFab();
+    Long ncut = 0;
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi) {
+        const auto& flag = flags[mfi];
+        const Box& bx = amrex::grow(mfi.validbox(), factory->getCentroid().nGrow());
+        for (BoxIterator bi(bx); bi.ok(); ++bi) {
+            if (flag(bi()).isSingleValued()) ++ncut;
+        }
+    }
+    Long nentries = factory->getSparseCentroid().numEntries();
+    ParallelDescriptor::ReduceLongSum(ncut);
+    ParallelDescriptor::ReduceLongSum(nentries);
+    AMREX_ALWAYS_ASSERT(nentries > 0 && nentries <= ncut);
+
+    // EB_interp_CC_to_Centroid against the dense kernel.
+    const int ncomp = 2;
+    MultiFab cc(ba, dm, ncomp, 1, MFInfo(), *factory);
+    for (MFIter mfi(cc); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.fabbox();
+        const auto& a = cc.array(mfi);
+        const auto problo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, ncomp, i, j, k, n,
+        {
+            AMREX_D_TERM(Real x = problo[0] + (i+0.5)*dx[0];,
+                         Real y = problo[1] + (j+0.5)*dx[1];,
+                         Real z = problo[2] + (k+0.5)*dx[2];)
+            a(i,j,k,n) = AMREX_D_TERM(std::sin(3.*x+n), + std::cos(2.*y), + x*z*z);
+        });
+    }
+
+    MultiFab cent(ba, dm, ncomp, 0, MFInfo(), *factory);
+    EB_interp_CC_to_Centroid(cent, cc, 0, 0, ncomp, geom);
+
+    MultiFab cent_dense(ba, dm, ncomp, 0);
+    const auto& centroid = factory->getCentroid();
+    for (MFIter mfi(cent_dense); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        const auto& d = cent_dense.array(mfi);
+        const auto& c = cc.const_array(mfi);
+        const auto fabtyp = flags[mfi].getType(bx);
+        if (fabtyp == FabType::covered) {
+            cent_dense[mfi].setVal<RunOn::Host>(0.0, bx, 0, ncomp);
+        } else if (fabtyp == FabType::regular) {
+            cent_dense[mfi].copy<RunOn::Host>(cc[mfi], bx, 0, bx, 0, ncomp);
+        } else {
+            eb_interp_cc2cent(bx, d, c, flags.const_array(mfi), centroid.const_array(mfi), ncomp);
+        }
+    }
+    compare(cent, cent_dense, 0, "EB_interp_CC_to_Centroid");
+
+    amrex::Print() << "SparseCutFab: the sparse EB data match the dense data\n";
+}
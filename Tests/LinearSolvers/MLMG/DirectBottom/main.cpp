@@ -0,0 +1,275 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+// Checks the direct bottom solvers BottomSolver::fft (constant
+// coefficients) and BottomSolver::lu (variable coefficients) with
+// Dirichlet, periodic, and Neumann (singular) boundaries:
+//   - with max_coarsening_level = 0 the bottom solve is the whole solve,
+//     so MLMG must converge in one iteration, also after the coefficients
+//     are changed between solves with the same MLMG;
+//   - a two-level solve must agree with BottomSolver::bicgstab, also after
+//     the coefficients are changed between solves with the same MLMG.
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+enum struct BCCase { dirichlet, periodic, neumann };
+
+int n_cell = 16;
+int max_grid_size = 8;
+int verbose = 0;
+
+struct Problem
+{
+    BCCase bc;
+    bool variable_coef;
+    Real beta = 1.0;
+    Vector<Geometry> geom;
+    Vector<BoxArray> grids;
+    Vector<DistributionMapping> dmap;
+    Vector<MultiFab> rhs;
+    Vector<MultiFab> acoef;
+    Vector<Array<MultiFab,AMREX_SPACEDIM> > bcoef;
+
+    Problem (BCCase a_bc, bool a_variable_coef, int nlevels);
+
+    bool singular () const { return bc == BCCase::neumann; }
+    Real alpha () const { return (bc == BCCase::periodic) ? 1.0 : 0.0; }
+
+    // Solves with bottom solver bs and returns the number of iterations
+    // of the last solve.  If bscale is not 1, the problem is solved a
+    // second time with the same MLMG after b (or beta for constant
+    // coefficients) is scaled.
+    int solve (Vector<MultiFab>& sol, BottomSolver bs, int max_coarsening_level,
+               Real bscale = 1.0) const;
+};
+
+Problem::Problem (BCCase a_bc, bool a_variable_coef, int nlevels)
+    : bc(a_bc), variable_coef(a_variable_coef)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    const int is_per = (bc == BCCase::periodic) ? 1 : 0;
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(is_per,is_per,is_per)};
+
+    geom.resize(nlevels);
+    grids.resize(nlevels);
+    dmap.resize(nlevels);
+    rhs.resize(nlevels);
+    acoef.resize(nlevels);
+    bcoef.resize(nlevels);
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    for (int ilev = 0; ilev < nlevels; ++ilev)
+    {
+        geom[ilev].define(domain, rb, 0, is_periodic);
+        if (ilev == 0) {
+            grids[ilev].define(domain);
+        } else {
+            // The middle half of the domain, touching no boundary.
+            grids[ilev].define(amrex::grow(domain, -domain.length(0)/4));
+        }
+        grids[ilev].maxSize(max_grid_size);
+        dmap[ilev].define(grids[ilev]);
+        domain.refine(2);
+    }
+
+    for (int ilev = 0; ilev < nlevels; ++ilev)
+    {
+        const auto dx = geom[ilev].CellSizeArray();
+        rhs[ilev].define(grids[ilev], dmap[ilev], 1, 0);
+        acoef[ilev].define(grids[ilev], dmap[ilev], 1, 0);
+        acoef[ilev].setVal(1.0);
+        for (MFIter mfi(rhs[ilev]); mfi.isValid(); ++mfi)
+        {
+            auto const& r = rhs[ilev].array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                const Real x = (i+0.5)*dx[0];
+                const Real y = (AMREX_SPACEDIM >= 2) ? (j+0.5)*dx[1] : 0.5;
+                const Real z = (AMREX_SPACEDIM == 3) ? (k+0.5)*dx[2] : 0.5;
+                r(i,j,k) = std::sin(6.2831853*x)*std::cos(6.2831853*y) + z*z + 0.3*x;
+            });
+        }
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            bcoef[ilev][idim].define(amrex::convert(grids[ilev], IntVect::TheDimensionVector(idim)),
+                                     dmap[ilev], 1, 0);
+            for (MFIter mfi(bcoef[ilev][idim]); mfi.isValid(); ++mfi)
+            {
+                auto const& b = bcoef[ilev][idim].array(mfi);
+                amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+                {
+                    b(i,j,k) = variable_coef ? 1.0 + idim + 0.8*std::sin(0.3*i+0.7*j+1.1*k) : 1.0;
+                });
+            }
+        }
+    }
+
+    if (singular()) {
+        // Make the single level problem solvable.
+        const Real avg = rhs[0].sum() / geom[0].Domain().d_numPts();
+        for (auto& r : rhs) {
+            r.plus(-avg, 0, 1);
+        }
+    }
+}
+
+int
+Problem::solve (Vector<MultiFab>& sol, BottomSolver bs, int max_coarsening_level,
+                Real bscale) const
+{
+    const int nlevels = geom.size();
+    sol.resize(nlevels);
+    for (int ilev = 0; ilev < nlevels; ++ilev) {
+        sol[ilev].define(grids[ilev], dmap[ilev], 1, 1);
+        sol[ilev].setVal(0.0);
+    }
+
+    LPInfo info;
+    info.setMaxCoarseningLevel(max_coarsening_level);
+    MLABecLaplacian mlabec(geom, grids, dmap, info);
+
+    Array<LinOpBCType,AMREX_SPACEDIM> bclo, bchi;
+    const LinOpBCType bctype = (bc == BCCase::dirichlet) ? LinOpBCType::Dirichlet
+                             : ((bc == BCCase::periodic) ? LinOpBCType::Periodic
+                                                         : LinOpBCType::Neumann);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bclo[idim] = bchi[idim] = bctype;
+    }
+    mlabec.setDomainBC(bclo, bchi);
+    mlabec.setMaxOrder(3);
+
+    mlabec.setScalars(alpha(), beta);
+    for (int ilev = 0; ilev < nlevels; ++ilev) {
+        mlabec.setLevelBC(ilev, nullptr);
+        mlabec.setACoeffs(ilev, acoef[ilev]);
+        mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(bcoef[ilev]));
+    }
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(verbose);
+    mlmg.setBottomSolver(bs);
+    mlmg.setBottomMaxIter(1000);
+    mlmg.setMaxIter(100);
+
+    const Real tol_rel = 1.e-11;
+    mlmg.solve(amrex::GetVecOfPtrs(sol), amrex::GetVecOfConstPtrs(rhs), tol_rel, 0.0);
+
+    if (bscale != 1.0)
+    {
+        if (variable_coef) {
+            Vector<Array<MultiFab,AMREX_SPACEDIM> > b2(nlevels);
+            for (int ilev = 0; ilev < nlevels; ++ilev) {
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    b2[ilev][idim].define(bcoef[ilev][idim].boxArray(), dmap[ilev], 1, 0);
+                    MultiFab::Copy(b2[ilev][idim], bcoef[ilev][idim], 0, 0, 1, 0);
+                    b2[ilev][idim].mult(bscale);
+                }
+                mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(b2[ilev]));
+            }
+        } else {
+            mlabec.setScalars(alpha(), beta*bscale);
+        }
+        for (auto& s : sol) {
+            s.setVal(0.0);
+        }
+        mlmg.solve(amrex::GetVecOfPtrs(sol), amrex::GetVecOfConstPtrs(rhs), tol_rel, 0.0);
+    }
+
+    if (singular()) {
+        const Real avg = sol[0].sum() / geom[0].Domain().d_numPts();
+        for (auto& s : sol) {
+            s.plus(-avg, 0, 1);
+        }
+    }
+
+    return mlmg.getNumIters();
+}
+
+std::string name (BottomSolver bs, BCCase bc)
+{
+    std::string r = (bs == BottomSolver::fft) ? "fft" : "lu";
+    r += (bc == BCCase::dirichlet) ? " Dirichlet" : ((bc == BCCase::periodic) ? " periodic" : " Neumann");
+    return r;
+}
+
+}
+
+void main_main ()
+{
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("verbose", verbose);
+    }
+
+    for (BottomSolver bs : {BottomSolver::fft, BottomSolver::lu})
+    {
+        for (BCCase bc : {BCCase::dirichlet, BCCase::periodic, BCCase::neumann})
+        {
+            const bool variable_coef = (bs == BottomSolver::lu);
+
+            for (Real bscale : {1.0, 2.5})
+            {
+                Problem prob(bc, variable_coef, 1);
+                Vector<MultiFab> sol;
+                const int niters = prob.solve(sol, bs, 0, bscale);
+                if (niters != 1) {
+                    amrex::Abort("DirectBottom: "+name(bs,bc)+" took "+std::to_string(niters)
+                                 +" iterations on a single level");
+                }
+            }
+
+            for (Real bscale : {1.0, 2.5})
+            {
+                Problem prob(bc, variable_coef, 2);
+                Vector<MultiFab> sol, sol_ref;
+                prob.solve(sol, bs, 30, bscale);
+
+                // The reference is only set up with the final coefficients.
+                if (variable_coef) {
+                    for (auto& b : prob.bcoef) {
+                        for (auto& bd : b) {
+                            bd.mult(bscale);
+                        }
+                    }
+                } else {
+                    prob.beta *= bscale;
+                }
+                prob.solve(sol_ref, BottomSolver::bicgstab, 30);
+
+                for (int ilev = 0; ilev < 2; ++ilev)
+                {
+                    MultiFab::Subtract(sol[ilev], sol_ref[ilev], 0, 0, 1, 0);
+                    const Real err = sol[ilev].norm0(0, 0);
+                    const Real mx = sol_ref[ilev].norm0(0, 0);
+                    amrex::Print() << "DirectBottom: " << name(bs,bc) << " b scale " << bscale
+                                   << " level " << ilev << ": max difference to bicgstab "
+                                   << err << " (max |phi| " << mx << ")\n";
+                    if (err > 1.e-8*mx) {
+                        amrex::Abort("DirectBottom: "+name(bs,bc)+" differs from bicgstab");
+                    }
+                }
+            }
+        }
+    }
+
+    amrex::Print() << "DirectBottom: all tests passed\n";
+}
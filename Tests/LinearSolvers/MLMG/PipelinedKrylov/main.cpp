@@ -0,0 +1,227 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLCGSolver.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+// Checks the pipelined Krylov solvers against the classical ones on a
+// variable coefficient Dirichlet problem:
+//   - MLCGSolver with Type::PipelinedBiCGStab and Type::PipelinedCG must
+//     reach the solution of Type::BiCGStab and Type::CG in a similar
+//     number of iterations;
+//   - MLMG with BottomSolver::pipelined_bicgstab and pipelined_cg must
+//     agree with BottomSolver::bicgstab and cg.
+// Run it on more than one process, so that the nonblocking reductions
+// of the pipelined solvers are exercised.
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+int n_cell = 32;
+int max_grid_size = 8;
+int verbose = 0;
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray grids;
+    DistributionMapping dmap;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+
+    Problem ();
+
+    void define (MLABecLaplacian& mlabec, int max_coarsening_level) const;
+};
+
+Problem::Problem ()
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    const Box domain(IntVect(0), IntVect(n_cell-1));
+    geom.define(domain, rb, 0, is_periodic);
+    grids.define(domain);
+    grids.maxSize(max_grid_size);
+    dmap.define(grids);
+
+    const auto dx = geom.CellSizeArray();
+    rhs.define(grids, dmap, 1, 0);
+    acoef.define(grids, dmap, 1, 0);
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        auto const& r = rhs.array(mfi);
+        auto const& a = acoef.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (AMREX_SPACEDIM >= 2) ? (j+0.5)*dx[1] : 0.5;
+            const Real z = (AMREX_SPACEDIM == 3) ? (k+0.5)*dx[2] : 0.5;
+            r(i,j,k) = std::sin(6.2831853*x)*std::cos(6.2831853*y) + z*z + 0.3*x;
+            a(i,j,k) = 1.0 + 0.5*std::cos(0.9*i+0.4*j+0.2*k);
+        });
+    }
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        bcoef[idim].define(amrex::convert(grids, IntVect::TheDimensionVector(idim)), dmap, 1, 0);
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            auto const& b = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                b(i,j,k) = 1.0 + idim + 0.8*std::sin(0.3*i+0.7*j+1.1*k);
+            });
+        }
+    }
+}
+
+void
+Problem::define (MLABecLaplacian& mlabec, int max_coarsening_level) const
+{
+    LPInfo info;
+    info.setMaxCoarseningLevel(max_coarsening_level);
+    mlabec.define({geom}, {grids}, {dmap}, info);
+
+    Array<LinOpBCType,AMREX_SPACEDIM> bclo, bchi;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bclo[idim] = bchi[idim] = LinOpBCType::Dirichlet;
+    }
+    mlabec.setDomainBC(bclo, bchi);
+    mlabec.setMaxOrder(2);
+    mlabec.setLevelBC(0, nullptr);
+    mlabec.setScalars(1.0, 1.0);
+    mlabec.setACoeffs(0, acoef);
+    mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+}
+
+std::string name (MLCGSolver::Type type)
+{
+    switch (type) {
+    case MLCGSolver::Type::BiCGStab:          return "bicgstab";
+    case MLCGSolver::Type::CG:                return "cg";
+    case MLCGSolver::Type::PipelinedBiCGStab: return "pipelined bicgstab";
+    default:                                  return "pipelined cg";
+    }
+}
+
+// Solves the single level problem with MLCGSolver and returns the number
+// of iterations.
+int solve_cg (const Problem& prob, MLCGSolver::Type type, MultiFab& sol)
+{
+    MLABecLaplacian mlabec;
+    prob.define(mlabec, 0);
+
+    sol.define(prob.grids, prob.dmap, 1, 1);
+    sol.setVal(0.0);
+
+    // MLMG::apply prepares the operator for MLCGSolver.
+    MLMG mlmg(mlabec);
+    MultiFab tmp(prob.grids, prob.dmap, 1, 0);
+    mlmg.apply({&tmp}, {&sol});
+
+    MLCGSolver cg(&mlmg, mlabec, type);
+    cg.setVerbose(verbose);
+    cg.setMaxIter(1000);
+    const int ret = cg.solve(sol, prob.rhs, 1.e-10, 0.0);
+    if (ret != 0) {
+        amrex::Abort("PipelinedKrylov: "+name(type)+" failed with "+std::to_string(ret));
+    }
+    return cg.getNumIters();
+}
+
+// Solves the problem with MLMG and returns the number of iterations.
+int solve_mlmg (const Problem& prob, BottomSolver bs, MultiFab& sol)
+{
+    MLABecLaplacian mlabec;
+    prob.define(mlabec, 30);
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(verbose);
+    mlmg.setBottomSolver(bs);
+    mlmg.setMaxIter(100);
+
+    sol.define(prob.grids, prob.dmap, 1, 1);
+    sol.setVal(0.0);
+    mlmg.solve({&sol}, {&prob.rhs}, 1.e-11, 0.0);
+    return mlmg.getNumIters();
+}
+
+void compare (const MultiFab& sol, const MultiFab& sol_ref, Real tol, const std::string& what)
+{
+    MultiFab diff(sol.boxArray(), sol.DistributionMap(), 1, 0);
+    MultiFab::Copy(diff, sol, 0, 0, 1, 0);
+    MultiFab::Subtract(diff, sol_ref, 0, 0, 1, 0);
+    const Real err = diff.norm0(0, 0);
+    const Real mx = sol_ref.norm0(0, 0);
+    amrex::Print() << "PipelinedKrylov: " << what << ": max difference " << err
+                   << " (max |phi| " << mx << ")\n";
+    if (err > tol*mx) {
+        amrex::Abort("PipelinedKrylov: "+what+" differs");
+    }
+}
+
+}
+
+void main_main ()
+{
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("verbose", verbose);
+    }
+
+    const Problem prob;
+
+    const std::pair<MLCGSolver::Type,MLCGSolver::Type> cg_pairs[] = {
+        {MLCGSolver::Type::BiCGStab, MLCGSolver::Type::PipelinedBiCGStab},
+        {MLCGSolver::Type::CG,       MLCGSolver::Type::PipelinedCG}
+    };
+    for (const auto& types : cg_pairs)
+    {
+        MultiFab sol_ref, sol;
+        const int niters_ref = solve_cg(prob, types.first, sol_ref);
+        const int niters = solve_cg(prob, types.second, sol);
+        amrex::Print() << "PipelinedKrylov: " << name(types.first) << " " << niters_ref
+                       << " iterations, " << name(types.second) << " " << niters << " iterations\n";
+        if (niters > niters_ref + niters_ref/5 + 2 || niters < niters_ref - niters_ref/5 - 2) {
+            amrex::Abort("PipelinedKrylov: "+name(types.second)+" took "+std::to_string(niters)
+                         +" iterations, "+name(types.first)+" "+std::to_string(niters_ref));
+        }
+        compare(sol, sol_ref, 1.e-7, name(types.second)+" vs "+name(types.first));
+    }
+
+    const std::pair<BottomSolver,BottomSolver> bottom_pairs[] = {
+        {BottomSolver::bicgstab, BottomSolver::pipelined_bicgstab},
+        {BottomSolver::cg,       BottomSolver::pipelined_cg}
+    };
+    for (const auto& bs : bottom_pairs)
+    {
+        MultiFab sol_ref, sol;
+        const int niters_ref = solve_mlmg(prob, bs.first, sol_ref);
+        const int niters = solve_mlmg(prob, bs.second, sol);
+        const std::string what = (bs.first == BottomSolver::cg) ? "MLMG with pipelined cg"
+                                                                : "MLMG with pipelined bicgstab";
+        if (std::abs(niters - niters_ref) > 1) {
+            amrex::Abort("PipelinedKrylov: "+what+" took "+std::to_string(niters)
+                         +" iterations instead of "+std::to_string(niters_ref));
+        }
+        compare(sol, sol_ref, 1.e-8, what);
+    }
+
+    amrex::Print() << "PipelinedKrylov: all tests passed\n";
+}
@@ -0,0 +1,238 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_VisMF.H>
+#include <AMReX_FileSystem.H>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace amrex;
+
+// Writes a MultiFab with VisMF::Write and reads it back with VisMF::Read
+// into the BoxArray on disk with another DistributionMapping or another
+// number of ghost cells, into a chopped BoxArray with more ghost cells,
+// and into a default constructed MultiFab.  The ghost cells on disk hold
+// other values than the valid cells, so that the test can check that
+// valid cells on disk take precedence and that cells not on disk are left
+// untouched.  It also checks that a binary index that does not belong to
+// the header is not used, and that compressed data with a 32-bit format
+// are rounded to single precision.
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+constexpr Real ghost_offset = 0.25;
+constexpr Real untouched = -1.0;
+
+Real value (int i, int j, int k, int n)
+{
+    return i + 100.*j + 10000.*k + 1.e6*n;
+}
+
+void check (const MultiFab& mf, const Box& domain, int ngrow_disk, const std::string& what)
+{
+    const Box& gdomain = amrex::grow(domain, ngrow_disk);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        auto const& a = mf.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            Real expected;
+            if (domain.contains(iv)) {
+                expected = value(i,j,k,n);
+            } else if (gdomain.contains(iv)) {
+                expected = value(i,j,k,n) + ghost_offset;
+            } else {
+                expected = untouched;
+            }
+            if (a(i,j,k,n) != expected) {
+                amrex::Abort("VisMF: "+what+" read a wrong value");
+            }
+        });
+    }
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    int nfiles = 2;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nfiles", nfiles);
+    }
+
+    const Box domain(IntVect(0), IntVect(n_cell-1));
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncomp = 2;
+    const int ngrow = 1;
+    MultiFab mf(ba, dm, ncomp, ngrow);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = value(i,j,k,n);
+            if (!vbx.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                a(i,j,k,n) += ghost_offset;
+            }
+        });
+    }
+
+    const std::string name = "vismf_test_mf";
+    VisMF::SetNOutFiles(nfiles);
+    VisMF::SetBinaryIndex(true);
+    VisMF::Write(mf, name);
+
+    for (bool single_read : {false, true})
+    {
+        VisMF::SetUseSingleRead(single_read);
+        const std::string what = single_read ? " with usesingleread" : "";
+
+        // The BoxArray on disk with the boxes in reverse order of processes
+        {
+            Vector<int> pmap = dm.ProcessorMap();
+            std::reverse(pmap.begin(), pmap.end());
+            MultiFab mf2(ba, DistributionMapping(pmap), ncomp, ngrow);
+            mf2.setVal(untouched);
+            VisMF::Read(mf2, name);
+            // The ghost cells are read too.
+            for (MFIter mfi(mf2); mfi.isValid(); ++mfi) {
+                auto const& a = mf2.const_array(mfi);
+                const Box& vbx = mfi.validbox();
+                amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n)
+                {
+                    const Real ghost = vbx.contains(IntVect(AMREX_D_DECL(i,j,k))) ? 0.0 : ghost_offset;
+                    if (a(i,j,k,n) != value(i,j,k,n) + ghost) {
+                        amrex::Abort("VisMF: reading with another DistributionMapping"+what
+                                     +" read a wrong value");
+                    }
+                });
+            }
+        }
+
+        // The BoxArray on disk with fewer and more ghost cells
+        for (int ng : {0, ngrow+1})
+        {
+            MultiFab mf2(ba, dm, ncomp, ng);
+            mf2.setVal(untouched);
+            VisMF::Read(mf2, name);
+            check(mf2, domain, ngrow, "reading with "+std::to_string(ng)+" ghost cells"+what);
+        }
+
+        // A chopped BoxArray with more ghost cells
+        {
+            BoxArray ba2(domain);
+            ba2.maxSize(max_grid_size/2);
+            MultiFab mf2(ba2, DistributionMapping(ba2), ncomp, ngrow+1);
+            mf2.setVal(untouched);
+            VisMF::Read(mf2, name);
+            check(mf2, domain, ngrow, "reading into a chopped BoxArray"+what);
+        }
+
+        // A BoxArray whose boxes cross the boxes on disk
+        {
+            BoxArray ba2(amrex::shift(domain, IntVect(max_grid_size/2)) & domain);
+            ba2.maxSize(max_grid_size);
+            MultiFab mf2(ba2, DistributionMapping(ba2), ncomp, 0);
+            mf2.setVal(untouched);
+            VisMF::Read(mf2, name);
+            check(mf2, domain, ngrow, "reading into a shifted BoxArray"+what);
+        }
+
+        // A default constructed MultiFab gets the BoxArray on disk.
+        {
+            MultiFab mf2;
+            VisMF::Read(mf2, name);
+            AMREX_ALWAYS_ASSERT(mf2.boxArray() == ba && mf2.nComp() == ncomp && mf2.nGrow() == ngrow);
+            MultiFab::Subtract(mf2, mf, 0, 0, ncomp, ngrow);
+            AMREX_ALWAYS_ASSERT(mf2.norm0(0, ngrow) == 0.0 && mf2.norm0(1, ngrow) == 0.0);
+        }
+    }
+
+    // The binary index is not used if the header has been replaced by one
+    // written without it, e.g., by an older version, and RemoveFiles
+    // removes it.
+    {
+        BoxArray ba3(domain);
+        ba3.maxSize(max_grid_size/2);
+        MultiFab mf3(ba3, DistributionMapping(ba3), 1, 0);
+        mf3.setVal(3.0);
+        const std::string name3 = "vismf_test_mf3";
+        VisMF::SetBinaryIndex(false);
+        VisMF::Write(mf3, name3);
+
+        if (ParallelDescriptor::IOProcessor()) {
+            AMREX_ALWAYS_ASSERT(FileSystem::Exists(name+"_HB"));
+            std::ifstream src(name3+"_H", std::ios::binary);
+            std::ofstream dst(name+"_H", std::ios::binary | std::ios::trunc);
+            dst << src.rdbuf();
+        }
+        ParallelDescriptor::Barrier();
+
+        MultiFab mf2;
+        VisMF::Read(mf2, name);
+        if (mf2.boxArray() != ba3 || mf2.nComp() != 1 || mf2.min(0) != 3.0 || mf2.max(0) != 3.0) {
+            amrex::Abort("VisMF: a stale binary index was used");
+        }
+
+        VisMF::RemoveFiles(name);
+        ParallelDescriptor::Barrier();
+        if (ParallelDescriptor::IOProcessor() &&
+            (FileSystem::Exists(name+"_H") || FileSystem::Exists(name+"_HB"))) {
+            amrex::Abort("VisMF: RemoveFiles left the header or the binary index");
+        }
+    }
+
+    // Compressed data with a 32-bit format keep single precision.
+    {
+        MultiFab mf3(ba, dm, 1, 0);
+        for (MFIter mfi(mf3); mfi.isValid(); ++mfi) {
+            auto const& a = mf3.array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                a(i,j,k) = 1.0/(1.0 + value(i,j,k,0));
+            });
+        }
+        const std::string name3 = "vismf_test_mf32";
+        FArrayBox::setFormat(FABio::FAB_NATIVE_32);
+        VisMF::SetCompression(FabCodec::Lossless);
+        VisMF::Write(mf3, name3);
+        VisMF::SetCompression(FabCodec::None);
+        FArrayBox::setFormat(FABio::FAB_NATIVE);
+
+        MultiFab mf2(ba, dm, 1, 0);
+        VisMF::Read(mf2, name3);
+        for (MFIter mfi(mf2); mfi.isValid(); ++mfi) {
+            auto const& a = mf2.const_array(mfi);
+            auto const& b = mf3.const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                if (a(i,j,k) != static_cast<Real>(static_cast<float>(b(i,j,k)))) {
+                    amrex::Abort("VisMF: compressed data were not rounded to the 32-bit format");
+                }
+            });
+        }
+    }
+
+    amrex::Print() << "VisMF: all tests passed\n";
+}
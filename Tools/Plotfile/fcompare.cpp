@@ -1,6 +1,7 @@
 #include <AMReX.H>
 #include <AMReX_Print.H>
 #include <AMReX_PlotFileUtil.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -36,6 +37,8 @@ int main_main()
     std::string zone_info_var_name;
     Vector<std::string> plot_names(1);
     bool abort_if_not_all_found = false;
+    bool exit_early = false;
+    bool box_errors = false;
 
     int farg = 1;
     while (farg <= narg) {
@@ -58,6 +61,10 @@ int main_main()
             rtol = std::stod(amrex::get_command_argument(++farg));
         } else if (fname == "--abort_if_not_all_found") {
             abort_if_not_all_found = true;            
+        } else if (fname == "-x" or fname == "--exit_early") {
+            exit_early = true;
+        } else if (fname == "-b" or fname == "--box_errors") {
+            box_errors = true;
         } else {
             break;
         }
@@ -79,7 +86,7 @@ int main_main()
             << " variable.\n"
             << "\n"
             << " usage:\n"
-            << "    fcompare [-n|--norm num] [-d|--diffvar var] [-z|--zone_info var] [-a|--allow_diff_grids] [-r|rel_tol] file1 file2\n"
+            << "    fcompare [-n|--norm num] [-d|--diffvar var] [-z|--zone_info var] [-a|--allow_diff_grids] [-r|rel_tol] [-x|--exit_early] [-b|--box_errors] file1 file2\n"
             << "\n"
             << " optional arguments:\n"
             << "    -n|--norm num         : what norm to use (default is 0 for inf norm)\n"
@@ -89,6 +96,10 @@ int main_main()
             << "                            to the maximum error for the given variable\n"
             << "    -a|--allow_diff_grids : allow different BoxArrays covering the same domain\n"
             << "    -r|--rel_tol rtol     : relative tolerance (default is 0)\n"
+            << "    -x|--exit_early       : stop at the first box with a difference, or with a\n"
+            << "                            relative tolerance, at the first variable that\n"
+            << "                            exceeds it\n"
+            << "    -b|--box_errors       : report the maximum absolute error of each box\n"
             << std::endl;
         return 0;
     }
@@ -177,19 +188,23 @@ int main_main()
                    << "  " << std::setw(24) << "(||A - B||/||A||)" << "\n"
                    << " " << std::string(76,'-') << "\n";
 
-    // go level-by-level and patch-by-patch and compare the data
-    for (int ilev = 0; ilev < nlevels; ++ilev)
+    // go level-by-level and box-by-box and compare the data.  Only one box
+    // of one variable of each plotfile is in memory at a time on a thread.
+    bool stopped_early = false;
+    for (int ilev = 0; ilev < nlevels && !stopped_early; ++ilev)
     {
-        if (pf_a.boxArray(ilev).empty() && pf_b.boxArray(ilev).empty()) {
+        const BoxArray& ba_a = pf_a.boxArray(ilev);
+        const DistributionMapping& dmap_a = pf_a.DistributionMap(ilev);
+        if (ba_a.empty() && pf_b.boxArray(ilev).empty()) {
             continue;
         }
-        bool grids_match = pf_a.boxArray(ilev) == pf_b.boxArray(ilev);
+        bool grids_match = ba_a == pf_b.boxArray(ilev);
         if (!grids_match && !allow_diff_grids) {
             amrex::Abort("ERROR: grids do not match");
         } else if (!grids_match) {
             // do they cover the same domain?
-            if (!pf_a.boxArray(ilev).contains(pf_b.boxArray(ilev)) ||
-                !pf_a.boxArray(ilev).contains(pf_b.boxArray(ilev))) {
+            if (!ba_a.contains(pf_b.boxArray(ilev)) ||
+                !pf_b.boxArray(ilev).contains(ba_a)) {
                 amrex::Abort("ERROR: grids do not cover same domain");
             }
         }
@@ -199,65 +214,136 @@ int main_main()
         Vector<Real> rerror_denom(ncomp_a, 0.0);
         Vector<int> has_nan_a(ncomp_a, false);
         Vector<int> has_nan_b(ncomp_a, false);
+        Vector<int> compared(ncomp_a, false);
+        Vector<LayoutData<Real> > box_err(box_errors ? ncomp_a : 0);
         for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-            if (ivar_b[icomp_a] >= 0) {
-                const MultiFab& mf_a = pf_a.get(ilev, names_a[icomp_a]);
-                MultiFab mf_b;
-                if (grids_match) {
-                    mf_b = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
-                } else {
-                    mf_b.define(mf_a.boxArray(), mf_a.DistributionMap(), 1, 0);
-                    MultiFab tmp = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
-                    mf_b.ParallelCopy(tmp);
+            if (ivar_b[icomp_a] < 0) continue;
+            if (stopped_early) break;
+
+            const std::string& name_a = names_a[icomp_a];
+            const std::string& name_b = names_b[ivar_b[icomp_a]];
+            const bool save_diff = icomp_a == save_var_a;
+            const bool find_zone = icomp_a == zone_info_var_a;
+            if (box_errors) box_err[icomp_a].define(ba_a, dmap_a);
+
+            // [0]: ||B-A||, [1]: ||A||, for the inf, 1 and 2 norms
+            Real emax = 0.0, esum = 0.0, esum2 = 0.0;
+            Real amax = 0.0, asum = 0.0, asum2 = 0.0;
+            int nan_a = false, nan_b = false;
+            int stop = false;
+            Real zone_err = std::numeric_limits<Real>::lowest();
+            IntVect zone_cell;
+            int zone_grid = -1;
+#ifdef _OPENMP
+#pragma omp parallel reduction(max:emax,amax) reduction(+:esum,esum2,asum,asum2) \
+                     reduction(||:nan_a,nan_b)
+#endif
+            for (MFIter mfi(ba_a, dmap_a, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+            {
+                int done;
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+                done = stop;
+                if (done) continue;
+
+                const Box& bx = mfi.validbox();
+                // When the grids match, this reads the FAB of the same
+                // index in both plotfiles.
+                FArrayBox fab_a = pf_a.get(ilev, bx, name_a);
+                FArrayBox fab_b = pf_b.get(ilev, bx, name_b);
+                Real* AMREX_RESTRICT pb = fab_b.dataPtr();
+                const Real* AMREX_RESTRICT pa = fab_a.dataPtr();
+                const Long npts = bx.numPts();
+
+                Real bmax = 0.0;
+                for (Long i = 0; i < npts; ++i) {
+                    nan_a = nan_a || std::isnan(pa[i]);
+                    nan_b = nan_b || std::isnan(pb[i]);
+                    const Real d = std::abs(pb[i] - pa[i]);
+                    const Real a = std::abs(pa[i]);
+                    bmax = std::max(bmax, d);
+                    esum += d;
+                    esum2 += d*d;
+                    amax = std::max(amax, a);
+                    asum += a;
+                    asum2 += a*a;
+                    pb[i] = d;  // fab_b now holds |B-A|
                 }
-                has_nan_a[icomp_a] = mf_a.contains_nan();
-                has_nan_b[icomp_a] = mf_b.contains_nan();
-                MultiFab::Subtract(mf_b,mf_a,0,0,1,0); // b = b - a
-                Real max_err = mf_b.norm0();
-                if (norm == 1) {
-                    aerror[icomp_a] = mf_b.norm1();
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm1();
-                } else if (norm == 2) {
-                    aerror[icomp_a] = mf_b.norm2();
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm2();
-                } else {
-                    aerror[icomp_a] = max_err;
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm0();
-                }
-
-                if (norm == 0) {
-                    rerror[icomp_a] /= rerror_denom[icomp_a];
-                } else {
-                    const auto& dx = pf_a.cellSize(ilev);
-                    Real dv = 1.0;
-                    for (int idim = 0; idim < dm; ++idim) {
-                        dv *= dx[idim];
+                emax = std::max(emax, bmax);
+
+                if (box_errors) box_err[icomp_a][mfi] = bmax;
+                if (save_diff) mf_array[ilev][mfi].copy<RunOn::Host>(fab_b);
+                if (find_zone && bmax > 0.0) {
+#ifdef _OPENMP
+#pragma omp critical (fcompare_zone)
+#endif
+                    if (bmax > zone_err) {
+                        zone_err = bmax;
+                        zone_cell = fab_b.maxIndex<RunOn::Host>(0);
+                        zone_grid = mfi.index();
                     }
-                    aerror[icomp_a] *= std::pow(dv,1./static_cast<Real>(norm));
-                    rerror[icomp_a] = rerror[icomp_a]/rerror_denom[icomp_a];
                 }
-
-                if (icomp_a == save_var_a or icomp_a == zone_info_var_a) {
-                    mf_b.abs(0,1);
+                if (exit_early && rtol == 0.0 && bmax > 0.0) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                    stop = true;
                 }
+            }
 
-                if (icomp_a == save_var_a) {
-                    MultiFab::Copy(mf_array[ilev], mf_b, 0, 0, 1, 0);
-                }
+            Real rmax[] = {emax, amax};
+            Real rsum[] = {esum, esum2, asum, asum2};
+            ParallelDescriptor::ReduceRealMax(rmax, 2);
+            ParallelDescriptor::ReduceRealSum(rsum, 4);
+            bool any_nan_a = nan_a, any_nan_b = nan_b;
+            ParallelDescriptor::ReduceBoolOr(any_nan_a);
+            ParallelDescriptor::ReduceBoolOr(any_nan_b);
+            has_nan_a[icomp_a] = any_nan_a;
+            has_nan_b[icomp_a] = any_nan_b;
+            compared[icomp_a] = true;
+
+            const Real max_err = rmax[0];
+            if (norm == 1) {
+                aerror[icomp_a] = rsum[0];
+                rerror_denom[icomp_a] = rsum[2];
+            } else if (norm == 2) {
+                aerror[icomp_a] = std::sqrt(rsum[1]);
+                rerror_denom[icomp_a] = std::sqrt(rsum[3]);
+            } else {
+                aerror[icomp_a] = max_err;
+                rerror_denom[icomp_a] = rmax[1];
+            }
+            rerror[icomp_a] = aerror[icomp_a];
 
-                if (icomp_a == zone_info_var_a) {
-                    if (max_err > err_zone.max_abs_err) {
-                        err_zone.max_abs_err = max_err;
-                        err_zone.level = ilev;
-                        err_zone.cell = mf_b.maxIndex(0);
-                        auto isects = pf_a.boxArray(ilev).intersections
-                            (Box(err_zone.cell,err_zone.cell), true, 0);
-                        err_zone.grid_index = isects[0].first;
-                    }
+            if (norm == 0) {
+                rerror[icomp_a] /= rerror_denom[icomp_a];
+            } else {
+                const auto& dx = pf_a.cellSize(ilev);
+                Real dv = 1.0;
+                for (int idim = 0; idim < dm; ++idim) {
+                    dv *= dx[idim];
                 }
+                aerror[icomp_a] *= std::pow(dv,1./static_cast<Real>(norm));
+                rerror[icomp_a] = rerror[icomp_a]/rerror_denom[icomp_a];
+            }
+
+            if (find_zone && max_err > 0.0 && max_err > err_zone.max_abs_err) {
+                // the process with the largest error owns the zone
+                const int nprocs = ParallelDescriptor::NProcs();
+                int owner = (zone_grid >= 0 && zone_err == max_err)
+                    ? ParallelDescriptor::MyProc() : nprocs;
+                ParallelDescriptor::ReduceIntMin(owner);
+                ParallelDescriptor::Bcast(zone_cell.getVect(), AMREX_SPACEDIM, owner);
+                ParallelDescriptor::Bcast(&zone_grid, 1, owner);
+                err_zone.max_abs_err = max_err;
+                err_zone.level = ilev;
+                err_zone.cell = zone_cell;
+                err_zone.grid_index = zone_grid;
+            }
+
+            if (exit_early) {
+                stopped_early = (rtol == 0.0) ? max_err > 0.0 : rerror[icomp_a] > rtol;
             }
         }
 
@@ -267,6 +353,10 @@ int main_main()
                 amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
                                << "  " << std::setw(50)
                                << "< variable not present in both files > \n";
+            } else if (!compared[icomp_a]) {
+                amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
+                               << "  " << std::setw(50)
+                               << "< not compared > \n";
             } else if (has_nan_a[icomp_a] and has_nan_b[icomp_a]) {
                 amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
                                << "  " << std::setw(50)
@@ -304,6 +394,31 @@ int main_main()
         for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
             any_nans = any_nans or has_nan_a[icomp_a] or has_nan_b[icomp_a];
         }
+
+        if (box_errors) {
+            amrex::Print() << "\n maximum absolute error of the boxes on level " << ilev
+                           << " with differences\n";
+            const int ioproc = ParallelDescriptor::IOProcessorNumber();
+            for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
+                if (!compared[icomp_a]) continue;
+                Vector<Real> errs(ba_a.size());
+                ParallelDescriptor::GatherLayoutDataToVector(box_err[icomp_a], errs, ioproc);
+                for (int i = 0; i < errs.size(); ++i) {
+                    if (errs[i] > 0.0) {
+                        amrex::Print() << " " << std::setw(24) << std::left << names_a[icomp_a]
+                                       << std::right << "  grid " << std::setw(6) << i
+                                       << "  " << ba_a[i]
+                                       << "  " << std::setprecision(10) << errs[i] << "\n";
+                    }
+                }
+            }
+            amrex::Print() << "\n";
+        }
+    }
+
+    if (stopped_early) {
+        amrex::Print() << " STOPPED at the first difference" << std::endl;
+        return EXIT_FAILURE;
     }
 
     if (save_var_a >= 0) {
@@ -325,24 +440,18 @@ int main_main()
 
     if (zone_info) {
         if (err_zone.max_abs_err > 0.) {
-            ParallelDescriptor::Barrier();
-            const DistributionMapping& dmap = pf_a.DistributionMap(err_zone.level);
-            bool owner_proc = ParallelDescriptor::MyProc() == dmap[err_zone.grid_index];
-
-            if (owner_proc) {
-                amrex::AllPrint() << std::endl
-                                  << " maximum error in " << zone_info_var_name << "\n"
-                                  << "   level = " << err_zone.level << " (i,j,k) = " << err_zone.cell << "\n";
-            }
-
-            for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-                const MultiFab& mf = pf_a.get(err_zone.level,names_a[icomp_a]);
-                if (owner_proc) {
-                    Real v = mf[err_zone.grid_index](err_zone.cell);
-                    amrex::AllPrint() << " " << std::setw(24)
-                                      << names_a[icomp_a] << "  "
-                                      << std::setw(24) << std::right
-                                      << v << "\n";
+            amrex::Print() << std::endl
+                           << " maximum error in " << zone_info_var_name << "\n"
+                           << "   level = " << err_zone.level << " (i,j,k) = " << err_zone.cell << "\n";
+
+            if (ParallelDescriptor::IOProcessor()) {
+                const Box cell(err_zone.cell, err_zone.cell);
+                for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
+                    Real v = pf_a.get(err_zone.level, cell, names_a[icomp_a])(err_zone.cell);
+                    amrex::Print() << " " << std::setw(24)
+                                   << names_a[icomp_a] << "  "
+                                   << std::setw(24) << std::right
+                                   << v << "\n";
                 }
             }
         }
@@ -0,0 +1,22 @@
+#!/usr/bin/env python
+
+# Merge the per-process trace files written by TinyProfiler with
+# tiny_profiler.trace = 1 into one file that can be loaded in
+# chrome://tracing or https://ui.perfetto.dev.
+
+import sys
+import json
+
+if len(sys.argv) < 3:
+  print("Usage: %s [output-file] [trace-files ...]" % sys.argv[0])
+  sys.exit(1)
+
+out_file = sys.argv[1]
+
+events = []
+for trace_file in sys.argv[2:]:
+  with open(trace_file, 'rt') as f:
+    events.extend(json.load(f)["traceEvents"])
+
+with open(out_file, 'wt') as f:
+  json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)